@@ -0,0 +1,100 @@
+/**
+ * @file repobench.cpp
+ *
+ * Repository benchmark
+ *
+ * Measures how long it takes to remove the item with the smallest or largest
+ * ID from a repository and to insert it again, for growing capacity. Only two
+ * items are stored, at the lowest and highest ID, so that each removal leaves
+ * a gap spanning the whole repository. Finding the new minimum or maximum ID
+ * should not take longer for larger capacities.
+ *
+ * Also measures the rate of category() lookups by ID in a repository of one
+ * million items spread evenly over 2, 21 and 126 categories (the number of
+ * link states for 1 and 6 node states, and of triple states for 6 node
+ * states). The lookup rate should not depend on the number of categories.
+ */
+
+#include <largenet/base/repo/CategorizedRepository.h>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+typedef repo::CategorizedRepository<int> Repository;
+
+/**
+ * Remove item @p id and insert it again, @p n times.
+ * @return Mean time per removal and insertion in nanoseconds.
+ */
+double removeInsert(Repository& r, repo::id_t id, const unsigned int n)
+{
+	const clock_t start = clock();
+	for (unsigned int i = 0; i < n; ++i)
+	{
+		r.remove(id);
+		id = r.insert(0, 0);
+	}
+	return 1e9 * (clock() - start) / CLOCKS_PER_SEC / n;
+}
+
+/**
+ * Look up the categories of all items in @p ids, @p n times.
+ * @param sum Sum of all categories found, so that the lookups are not
+ * optimized away.
+ * @return Lookups per second in millions.
+ */
+double categoryLookups(const Repository& r, const vector<repo::id_t>& ids,
+		const unsigned int n, unsigned long& sum)
+{
+	const clock_t start = clock();
+	for (unsigned int i = 0; i < n; ++i)
+	{
+		for (vector<repo::id_t>::const_iterator it = ids.begin(); it
+				!= ids.end(); ++it)
+			sum += r.category(*it);
+	}
+	return 1e-6 * ids.size() * n * CLOCKS_PER_SEC / (clock() - start);
+}
+
+int main()
+{
+	const unsigned int repetitions = 200000;
+
+	cout << "# capacity\tmin [ns]\tmax [ns]\n";
+	for (repo::address_t capacity = 1 << 10; capacity <= 1 << 24; capacity <<= 2)
+	{
+		Repository r(1, capacity);
+		// IDs are handed out lowest first, so fill up and keep both ends only
+		for (repo::address_t i = 0; i < capacity; ++i)
+			r.insert(0, 0);
+		for (repo::id_t id = 1; id < capacity - 1; ++id)
+			r.remove(id);
+
+		const double tmin = removeInsert(r, r.minID(), repetitions);
+		const double tmax = removeInsert(r, r.maxID(), repetitions);
+		cout << capacity << "\t" << tmin << "\t" << tmax << "\n";
+	}
+
+	const repo::address_t items = 1 << 20;
+	const repo::category_t categories[] = { 2, 21, 126 };
+	vector<repo::id_t> ids(items);
+	srand(1);
+	for (vector<repo::id_t>::iterator it = ids.begin(); it != ids.end(); ++it)
+		*it = rand() % items;
+
+	cout << "\n# categories\tlookups [M/s]\n";
+	for (unsigned int c = 0; c < sizeof(categories) / sizeof(categories[0]); ++c)
+	{
+		Repository r(categories[c], items);
+		for (repo::address_t i = 0; i < items; ++i)
+			r.insert(0, i % categories[c]);
+
+		unsigned long sum = 0;
+		const double rate = categoryLookups(r, ids, 20, sum);
+		cout << categories[c] << "\t" << rate << "\t# " << sum << "\n";
+	}
+	return 0;
+}
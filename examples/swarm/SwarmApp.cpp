@@ -39,11 +39,14 @@ SwarmApp::SwarmApp(int argc, char** argv)
 
 		net_ = auto_ptr<TripleNetwork> (new TripleNetwork(opts_.N, opts_.L,	SwarmModel::node_states));
 
-		model_ = auto_ptr<SwarmModel> (new SwarmModel(*net_, opts_.par));
 		if (!opts_.loadNetFile.empty())
 			loadNetFile();
 		else
 			init();
+		/* The model registers its state groups with the network, so it must be
+		 * created after loading, which resets the network and drops all groups
+		 */
+		model_ = auto_ptr<SwarmModel> (new SwarmModel(*net_, opts_.par));
 	} catch (boost::program_options::error& e)
 	{
 		cerr << e.what() << "\n";
@@ -78,6 +81,10 @@ void SwarmApp::initNodeStates()
 	assert(opts_.l0 >= 0);
 	assert(opts_.l0 <= 1.0);
 
+	/* Link and triple states are updated once at the end
+	 */
+	net_->beginBatch();
+
 	/* First assigns R_r state to all nodes
 	 */
 
@@ -123,6 +130,7 @@ void SwarmApp::initNodeStates()
 			net_->setNodeState(*it4, SwarmModel::Runinf);
 		++it4;
 	}
+	net_->commitBatch();
 }
 
 
@@ -105,14 +105,17 @@ public:
 	const align_event_list& alignEvents() const;
 
 private:
-	void persuasion(TripleState s, double t);
-	void conviction(LinkState s, double t);
+	void persuasion(lnet::state_group_t g, double t);
+	void conviction(lnet::state_group_t g, double t);
 	void switchState(NodeState s, double t);
 	void createLink(NodeState a, NodeState b);
-	void destroyLink(LinkState s);
+	void destroyLink(lnet::state_group_t g);
 
 	lnet::TripleNetwork& net_;
 	Params par_;
+	lnet::state_group_t lNodes_, rNodes_; ///< left and right nodes
+	lnet::state_group_t lrLinks_, llLinks_, rrLinks_; ///< links by direction of their nodes
+	lnet::state_group_t rlrTriples_, lrlTriples_; ///< triples with the center node opposite to both outer ones
 	event_list switchEvents_;
 	align_event_list alignEvents_;
 };
@@ -47,6 +47,9 @@ int main(int argc, char **argv)
 	// Connect the nodes randomly to form a random, Erdős-Rényi type network.
 	generators::randomNetworkGnm(net, L);
 
+	// Defer link state updates until all initial node states are set
+	net.beginBatch();
+
 	// Iterate over all nodes in the network
 	Network::NodeIteratorRange nodes = net.nodes();
 	for (Network::NodeIterator n = nodes.first; n != nodes.second; ++n)
@@ -65,6 +68,7 @@ int main(int argc, char **argv)
 		net.setNodeState(*n, VoterModel::DOWN);
 		++n;
 	}
+	net.commitBatch();
 
 	// Create a VoterModel object that uses the Network object and works with
 	// the rewiring rate p
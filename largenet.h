@@ -14,8 +14,12 @@
 #include <largenet/base/types.h>
 #include <largenet/base/state_calculators.h>
 #include <largenet/MultiNetwork.h>
+#include <largenet/FlatMultiNetwork.h>
+#include <largenet/PartitionedMultiNetwork.h>
 #include <largenet/Network.h>
 #include <largenet/TripleMultiNetwork.h>
 #include <largenet/TripleNetwork.h>
+#include <largenet/CSRSnapshot.h>
+#include <largenet/NetworkBuilder.h>
 
 #endif /* LARGENET_H_ */
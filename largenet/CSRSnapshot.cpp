@@ -0,0 +1,133 @@
+/**
+ * This work is licensed under the Creative Commons
+ * Attribution-NonCommercial 3.0 Unported License. To view a copy of this
+ * license, visit http://creativecommons.org/licenses/by-nc/3.0/ or send a
+ * letter to Creative Commons, 444 Castro Street, Suite 900, Mountain View,
+ * California, 94041, USA.
+ */
+#include "CSRSnapshot.h"
+#include <algorithm>
+
+namespace lnet
+{
+
+CSRSnapshot::CSRSnapshot() :
+	offsets_(1, 0), nodeStateOffsets_(1, 0), linkStateOffsets_(1, 0)
+{
+}
+
+CSRSnapshot::CSRSnapshot(const BasicNetwork& net)
+{
+	assign(net);
+}
+
+void CSRSnapshot::assign(const BasicNetwork& net)
+{
+	const id_size_t nNodes = net.numberOfNodes(), nLinks = net.numberOfLinks();
+	const node_state_size_t nNodeStates = net.numberOfNodeStates();
+	const link_state_size_t nLinkStates = net.numberOfLinkStates();
+
+	// dense node IDs; network iterators visit IDs in ascending order
+	nodeIDs_.clear();
+	nodeIDs_.reserve(nNodes);
+	node_id_t maxID = 0;
+	BasicNetwork::NodeIteratorRange niters = net.nodes();
+	for (BasicNetwork::NodeIterator& it = niters.first; it != niters.second; ++it)
+	{
+		nodeIDs_.push_back(*it);
+		maxID = std::max(maxID, *it);
+	}
+	std::vector<node_id_t> dense(nNodes > 0 ? maxID + 1 : 0);
+	nodeStates_.resize(nNodes);
+	for (node_id_t i = 0; i < nNodes; ++i)
+	{
+		dense[nodeIDs_[i]] = i;
+		nodeStates_[i] = net.nodeState(nodeIDs_[i]);
+	}
+
+	// links and node degrees
+	linkIDs_.clear();
+	linkIDs_.reserve(nLinks);
+	BasicNetwork::LinkIteratorRange liters = net.links();
+	for (BasicNetwork::LinkIterator& it = liters.first; it != liters.second; ++it)
+		linkIDs_.push_back(*it);
+	sources_.resize(nLinks);
+	targets_.resize(nLinks);
+	linkStates_.resize(nLinks);
+	offsets_.assign(nNodes + 1, 0);
+	for (link_id_t l = 0; l < nLinks; ++l)
+	{
+		sources_[l] = dense[net.source(linkIDs_[l])];
+		targets_[l] = dense[net.target(linkIDs_[l])];
+		linkStates_[l] = net.linkState(linkIDs_[l]);
+		++offsets_[sources_[l] + 1];
+		++offsets_[targets_[l] + 1];
+	}
+	for (node_id_t i = 0; i < nNodes; ++i)
+		offsets_[i + 1] += offsets_[i];
+
+	// Each node has as many entries in its own list as it has entries
+	// pointing to it, so we can first bucket all entries by neighbor and then
+	// distribute them to their owners in neighbor order. Thus, neighbor lists
+	// come out sorted without any comparisons.
+	std::vector<node_id_t> owners(offsets_[nNodes]);
+	std::vector<link_id_t> via(offsets_[nNodes]);
+	offset_vector pos(offsets_.begin(), offsets_.end() - 1);
+	for (link_id_t l = 0; l < nLinks; ++l)
+	{
+		owners[pos[targets_[l]]] = sources_[l];
+		via[pos[targets_[l]]++] = l;
+		owners[pos[sources_[l]]] = targets_[l];
+		via[pos[sources_[l]]++] = l;
+	}
+	neighbors_.resize(offsets_[nNodes]);
+	adjLinks_.resize(offsets_[nNodes]);
+	pos.assign(offsets_.begin(), offsets_.end() - 1);
+	for (node_id_t v = 0; v < nNodes; ++v)
+	{
+		for (id_size_t i = offsets_[v]; i < offsets_[v + 1]; ++i)
+		{
+			const node_id_t u = owners[i];
+			neighbors_[pos[u]] = v;
+			adjLinks_[pos[u]++] = via[i];
+		}
+	}
+
+	// group nodes and links by state
+	nodeStateOffsets_.assign(nNodeStates + 1, 0);
+	for (node_id_t i = 0; i < nNodes; ++i)
+		++nodeStateOffsets_[nodeStates_[i] + 1];
+	for (node_state_t s = 0; s < nNodeStates; ++s)
+		nodeStateOffsets_[s + 1] += nodeStateOffsets_[s];
+	nodesByState_.resize(nNodes);
+	pos.assign(nodeStateOffsets_.begin(), nodeStateOffsets_.end() - 1);
+	for (node_id_t i = 0; i < nNodes; ++i)
+		nodesByState_[pos[nodeStates_[i]]++] = i;
+
+	linkStateOffsets_.assign(nLinkStates + 1, 0);
+	for (link_id_t l = 0; l < nLinks; ++l)
+		++linkStateOffsets_[linkStates_[l] + 1];
+	for (link_state_t s = 0; s < nLinkStates; ++s)
+		linkStateOffsets_[s + 1] += linkStateOffsets_[s];
+	linksByState_.resize(nLinks);
+	pos.assign(linkStateOffsets_.begin(), linkStateOffsets_.end() - 1);
+	for (link_id_t l = 0; l < nLinks; ++l)
+		linksByState_[pos[linkStates_[l]]++] = l;
+
+	lsCalc_.assign(net.linkStateCalculator(), nNodeStates);
+}
+
+std::pair<bool, link_id_t> CSRSnapshot::isLink(const node_id_t source,
+		const node_id_t target) const
+{
+	node_id_t a = source, b = target;
+	if (degree(a) > degree(b))
+		std::swap(a, b);
+	NeighborIteratorRange iters = neighbors(a);
+	NeighborIterator it = std::lower_bound(iters.first, iters.second, b);
+	if ((it != iters.second) && (*it == b))
+		return std::make_pair(true, adjLinks_[it - &neighbors_[0]]);
+	return std::make_pair(false, 0);
+}
+
+}
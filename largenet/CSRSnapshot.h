@@ -0,0 +1,304 @@
+/**
+ * This work is licensed under the Creative Commons
+ * Attribution-NonCommercial 3.0 Unported License. To view a copy of this
+ * license, visit http://creativecommons.org/licenses/by-nc/3.0/ or send a
+ * letter to Creative Commons, 444 Castro Street, Suite 900, Mountain View,
+ * California, 94041, USA.
+ */
+/**
+ * @file CSRSnapshot.h
+ * Declaration of the lnet::CSRSnapshot class.
+ */
+#ifndef CSRSNAPSHOT_H_
+#define CSRSNAPSHOT_H_
+
+#include <largenet/base/types.h>
+#include <largenet/base/traits.h>
+#include <largenet/base/state_calculators.h>
+#include <largenet/base/BasicNetwork.h>
+#include <vector>
+#include <utility>
+#include <cassert>
+
+namespace lnet
+{
+
+/**
+ * Frozen, read-only copy of a network in compressed sparse row layout.
+ *
+ * A snapshot is built in O(N + L) from any network and does not refer to it
+ * afterwards, so that measurements can run on it while the network keeps
+ * changing. Nodes and links are renumbered densely from zero in ascending
+ * order of their IDs in the network; originalNodeID() and originalLinkID()
+ * map back. The neighbors of each node are stored contiguously and sorted by
+ * node ID, together with the connecting links.
+ *
+ * %CSRSnapshot provides the read-only part of the network interface used by
+ * the templates in measures.h, path.h and component.h. All ID iterators are
+ * plain pointers. nodes() and links() list IDs grouped by state.
+ */
+class CSRSnapshot
+{
+public:
+	typedef const node_id_t* NodeIterator; ///< %Node ID iterator type.
+	typedef NodeIterator NodeStateIterator; ///< %Node ID in state iterator type.
+	typedef std::pair<NodeIterator, NodeIterator> NodeIteratorRange; ///< %Node ID iterator range type.
+	typedef NodeIteratorRange NodeStateIteratorRange; ///< %Node ID in state iterator range type.
+	typedef const link_id_t* LinkIterator; ///< %Link ID iterator type.
+	typedef LinkIterator LinkStateIterator; ///< %Link ID in state iterator type.
+	typedef std::pair<LinkIterator, LinkIterator> LinkIteratorRange; ///< %Link ID iterator range type.
+	typedef LinkIteratorRange LinkStateIteratorRange; ///< %Link ID in state iterator range type.
+	typedef const node_id_t* NeighborIterator; ///< Neighbor ID iterator type.
+	typedef std::pair<NeighborIterator, NeighborIterator> NeighborIteratorRange; ///< Neighbor iterator range type.
+	typedef const link_id_t* NeighborLinkIterator; ///< %Link ID iterator type for neighboring links of a given node.
+	typedef std::pair<NeighborLinkIterator, NeighborLinkIterator> NeighborLinkIteratorRange; ///< %Link ID iterator range type for neighboring links of a given node.
+
+	typedef allow_parallel_edge_tag edge_parallel_category;
+	typedef no_count_triples_tag triple_counting_category;
+
+	/**
+	 * Default constructor. Creates an empty snapshot.
+	 */
+	CSRSnapshot();
+	/**
+	 * Constructor. Takes a snapshot of network @p net.
+	 * @param net Network to take a snapshot of.
+	 */
+	explicit CSRSnapshot(const BasicNetwork& net);
+
+	/**
+	 * Replace contents with a snapshot of network @p net, reusing allocated
+	 * memory.
+	 * @param net Network to take a snapshot of.
+	 */
+	void assign(const BasicNetwork& net);
+
+	id_size_t numberOfNodes() const;
+	id_size_t numberOfNodes(node_state_t s) const;
+	id_size_t numberOfLinks() const;
+	id_size_t numberOfLinks(link_state_t s) const;
+	node_state_size_t numberOfNodeStates() const;
+	link_state_size_t numberOfLinkStates() const;
+
+	NodeIteratorRange nodes() const;
+	NodeStateIteratorRange nodes(node_state_t s) const;
+	LinkIteratorRange links() const;
+	LinkStateIteratorRange links(link_state_t s) const;
+	/**
+	 * Return iterator range of all neighbors of node @p n, sorted by ID.
+	 * @param n %Node ID
+	 * @return Iterator range for neighboring node IDs.
+	 */
+	NeighborIteratorRange neighbors(node_id_t n) const;
+	/**
+	 * Return iterator range of all links of node @p n, in the same order as
+	 * neighbors(@p n).
+	 * @param n %Node ID
+	 * @return Iterator range for neighboring link IDs.
+	 */
+	NeighborLinkIteratorRange neighborLinks(node_id_t n) const;
+
+	id_size_t degree(node_id_t n) const;
+	/**
+	 * Return number of neighbors of node @p n in state @p s, by scanning its
+	 * neighbors.
+	 * @param n %Node ID
+	 * @param s %Node state
+	 */
+	id_size_t neighborsInState(node_id_t n, node_state_t s) const;
+	/**
+	 * Return false: a snapshot keeps no neighbor state counts, so
+	 * neighborsInState() always scans.
+	 */
+	bool hasNeighborStateCounts() const;
+	node_state_t nodeState(node_id_t n) const;
+	link_state_t linkState(link_id_t l) const;
+	node_id_t source(link_id_t l) const;
+	node_id_t target(link_id_t l) const;
+	/**
+	 * Check for a link between @p source and @p target by binary search.
+	 * @param source %Node ID
+	 * @param target %Node ID
+	 * @return Pair of bool and link ID. If @p first is false, there is no such
+	 * link and the returned link ID is invalid.
+	 */
+	std::pair<bool, link_id_t> isLink(node_id_t source, node_id_t target) const;
+
+	/**
+	 * Return the link state calculator of the network at the time the
+	 * snapshot was taken, as a lookup table.
+	 */
+	const LinkStateCalculator& linkStateCalculator() const;
+
+	/**
+	 * Return ID of node @p n in the network the snapshot was taken of.
+	 * @param n %Node ID in the snapshot.
+	 */
+	node_id_t originalNodeID(node_id_t n) const;
+	/**
+	 * Return ID of link @p l in the network the snapshot was taken of.
+	 * @param l %Link ID in the snapshot.
+	 */
+	link_id_t originalLinkID(link_id_t l) const;
+
+private:
+	typedef std::vector<id_size_t> offset_vector;
+
+	offset_vector offsets_; ///< start of each node's neighbors in neighbors_ and adjLinks_
+	std::vector<node_id_t> neighbors_; ///< neighbor IDs
+	std::vector<link_id_t> adjLinks_; ///< IDs of links to neighbors
+	std::vector<node_state_t> nodeStates_; ///< node states
+	std::vector<link_state_t> linkStates_; ///< link states
+	std::vector<node_id_t> sources_; ///< link source IDs
+	std::vector<node_id_t> targets_; ///< link target IDs
+	std::vector<node_id_t> nodesByState_; ///< node IDs grouped by state
+	offset_vector nodeStateOffsets_; ///< start of each state in nodesByState_
+	std::vector<link_id_t> linksByState_; ///< link IDs grouped by state
+	offset_vector linkStateOffsets_; ///< start of each state in linksByState_
+	std::vector<node_id_t> nodeIDs_; ///< original node IDs
+	std::vector<link_id_t> linkIDs_; ///< original link IDs
+	LinkStateTable lsCalc_; ///< link state table
+};
+
+inline id_size_t CSRSnapshot::numberOfNodes() const
+{
+	return nodeStates_.size();
+}
+
+inline id_size_t CSRSnapshot::numberOfNodes(const node_state_t s) const
+{
+	assert(s + 1 < nodeStateOffsets_.size());
+	return nodeStateOffsets_[s + 1] - nodeStateOffsets_[s];
+}
+
+inline id_size_t CSRSnapshot::numberOfLinks() const
+{
+	return linkStates_.size();
+}
+
+inline id_size_t CSRSnapshot::numberOfLinks(const link_state_t s) const
+{
+	assert(s + 1 < linkStateOffsets_.size());
+	return linkStateOffsets_[s + 1] - linkStateOffsets_[s];
+}
+
+inline node_state_size_t CSRSnapshot::numberOfNodeStates() const
+{
+	return nodeStateOffsets_.size() - 1;
+}
+
+inline link_state_size_t CSRSnapshot::numberOfLinkStates() const
+{
+	return linkStateOffsets_.size() - 1;
+}
+
+inline CSRSnapshot::NodeIteratorRange CSRSnapshot::nodes() const
+{
+	const node_id_t* p = nodesByState_.empty() ? 0 : &nodesByState_[0];
+	return std::make_pair(p, p + nodesByState_.size());
+}
+
+inline CSRSnapshot::NodeStateIteratorRange CSRSnapshot::nodes(
+		const node_state_t s) const
+{
+	const node_id_t* p = nodes().first;
+	return std::make_pair(p + nodeStateOffsets_[s], p + nodeStateOffsets_[s + 1]);
+}
+
+inline CSRSnapshot::LinkIteratorRange CSRSnapshot::links() const
+{
+	const link_id_t* p = linksByState_.empty() ? 0 : &linksByState_[0];
+	return std::make_pair(p, p + linksByState_.size());
+}
+
+inline CSRSnapshot::LinkStateIteratorRange CSRSnapshot::links(
+		const link_state_t s) const
+{
+	const link_id_t* p = links().first;
+	return std::make_pair(p + linkStateOffsets_[s], p + linkStateOffsets_[s + 1]);
+}
+
+inline CSRSnapshot::NeighborIteratorRange CSRSnapshot::neighbors(
+		const node_id_t n) const
+{
+	assert(n < numberOfNodes());
+	const node_id_t* p = neighbors_.empty() ? 0 : &neighbors_[0];
+	return std::make_pair(p + offsets_[n], p + offsets_[n + 1]);
+}
+
+inline CSRSnapshot::NeighborLinkIteratorRange CSRSnapshot::neighborLinks(
+		const node_id_t n) const
+{
+	assert(n < numberOfNodes());
+	const link_id_t* p = adjLinks_.empty() ? 0 : &adjLinks_[0];
+	return std::make_pair(p + offsets_[n], p + offsets_[n + 1]);
+}
+
+inline id_size_t CSRSnapshot::degree(const node_id_t n) const
+{
+	assert(n < numberOfNodes());
+	return offsets_[n + 1] - offsets_[n];
+}
+
+inline id_size_t CSRSnapshot::neighborsInState(const node_id_t n,
+		const node_state_t s) const
+{
+	assert(n < numberOfNodes());
+	id_size_t count = 0;
+	for (offset_vector::value_type i = offsets_[n]; i < offsets_[n + 1]; ++i)
+	{
+		if (nodeStates_[neighbors_[i]] == s)
+			++count;
+	}
+	return count;
+}
+
+inline bool CSRSnapshot::hasNeighborStateCounts() const
+{
+	return false;
+}
+
+inline node_state_t CSRSnapshot::nodeState(const node_id_t n) const
+{
+	assert(n < numberOfNodes());
+	return nodeStates_[n];
+}
+
+inline link_state_t CSRSnapshot::linkState(const link_id_t l) const
+{
+	assert(l < numberOfLinks());
+	return linkStates_[l];
+}
+
+inline node_id_t CSRSnapshot::source(const link_id_t l) const
+{
+	assert(l < numberOfLinks());
+	return sources_[l];
+}
+
+inline node_id_t CSRSnapshot::target(const link_id_t l) const
+{
+	assert(l < numberOfLinks());
+	return targets_[l];
+}
+
+inline const LinkStateCalculator& CSRSnapshot::linkStateCalculator() const
+{
+	return lsCalc_;
+}
+
+inline node_id_t CSRSnapshot::originalNodeID(const node_id_t n) const
+{
+	assert(n < numberOfNodes());
+	return nodeIDs_[n];
+}
+
+inline link_id_t CSRSnapshot::originalLinkID(const link_id_t l) const
+{
+	assert(l < numberOfLinks());
+	return linkIDs_[l];
+}
+
+}
+
+#endif /* CSRSNAPSHOT_H_ */
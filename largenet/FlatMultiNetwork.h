@@ -0,0 +1,33 @@
+/**
+ * This work is licensed under the Creative Commons
+ * Attribution-NonCommercial 3.0 Unported License. To view a copy of this
+ * license, visit http://creativecommons.org/licenses/by-nc/3.0/ or send a
+ * letter to Creative Commons, 444 Castro Street, Suite 900, Mountain View,
+ * California, 94041, USA.
+ */
+
+/**
+ * @file FlatMultiNetwork.h
+ * Declaration of the lnet::FlatMultiNetwork class.
+ */
+#ifndef FLATMULTINETWORK_H_
+#define FLATMULTINETWORK_H_
+
+#include <largenet/base/FlatNode.h>
+#include <largenet/base/FlatLink.h>
+#include <largenet/base/TypedNetwork.h>
+
+namespace lnet
+{
+
+/**
+ * A MultiNetwork whose nodes store their adjacent links in contiguous arrays
+ * (see FlatNode). Adding and removing links takes constant time independent of
+ * node degree, and so does drawing a random neighbor. The order in which
+ * neighbors are visited is unspecified and changes when links are removed.
+ */
+typedef TypedNetwork<FlatNode, FlatLink> FlatMultiNetwork;
+
+}
+
+#endif /* FLATMULTINETWORK_H_ */
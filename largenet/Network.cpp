@@ -6,6 +6,7 @@
  * California, 94041, USA.
  */
 #include "Network.h"
+#include "NetworkBuilder.h"
 
 namespace lnet
 {
@@ -45,6 +46,13 @@ link_id_t Network::doAddLink(const node_id_t source, const node_id_t target)
 	return l;
 }
 
+void Network::doAddLinks(const EdgeList& edges)
+{
+	EdgeList unique(edges);
+	removeParallelEdges(unique, *this);
+	MultiNetwork::doAddLinks(unique);
+}
+
 bool Network::doChangeLink(const link_id_t l, const node_id_t source,
 		const node_id_t target)
 {
@@ -66,6 +66,13 @@ protected:
 	 * @return Unique ID of link created
 	 */
 	link_id_t doAddLink(node_id_t source, node_id_t target);
+	/**
+	 * Add links between the node pairs in @p edges at once. Pairs that are
+	 * already connected, or that appear more than once in @p edges, give
+	 * only one link.
+	 * @param edges (source, target) pairs of node IDs.
+	 */
+	void doAddLinks(const EdgeList& edges);
 
 	/**
 	 * Change link to connect the new @p source with the new @p target.
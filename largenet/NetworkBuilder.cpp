@@ -0,0 +1,110 @@
+/**
+ * This work is licensed under the Creative Commons
+ * Attribution-NonCommercial 3.0 Unported License. To view a copy of this
+ * license, visit http://creativecommons.org/licenses/by-nc/3.0/ or send a
+ * letter to Creative Commons, 444 Castro Street, Suite 900, Mountain View,
+ * California, 94041, USA.
+ */
+#include "NetworkBuilder.h"
+#include <algorithm>
+
+namespace lnet
+{
+
+void removeParallelEdges(EdgeList& edges)
+{
+	if (edges.empty())
+		return;
+	id_size_t nNodes = 0;
+	for (EdgeList::const_iterator e = edges.begin(); e != edges.end(); ++e)
+	{
+		const node_id_t m = std::max(e->first, e->second) + 1;
+		if (m > nNodes)
+			nNodes = m;
+	}
+
+	// bucket edges by their smaller end node, keeping their order
+	std::vector<id_size_t> offsets(nNodes + 1, 0);
+	for (EdgeList::const_iterator e = edges.begin(); e != edges.end(); ++e)
+		++offsets[std::min(e->first, e->second) + 1];
+	for (node_id_t n = 0; n < nNodes; ++n)
+		offsets[n + 1] += offsets[n];
+	std::vector<id_size_t> order(edges.size());
+	std::vector<id_size_t> pos(offsets.begin(), offsets.end() - 1);
+	for (id_size_t i = 0; i < edges.size(); ++i)
+		order[pos[std::min(edges[i].first, edges[i].second)]++] = i;
+
+	// within a bucket, mark the larger end nodes seen so far
+	std::vector<node_id_t> seen(nNodes, 0); // bucket + 1, 0 for none
+	std::vector<bool> keep(edges.size(), false);
+	for (node_id_t n = 0; n < nNodes; ++n)
+	{
+		for (id_size_t k = offsets[n]; k < offsets[n + 1]; ++k)
+		{
+			const id_size_t i = order[k];
+			const node_id_t m = std::max(edges[i].first, edges[i].second);
+			if (seen[m] != n + 1)
+			{
+				seen[m] = n + 1;
+				keep[i] = true;
+			}
+		}
+	}
+
+	id_size_t j = 0;
+	for (id_size_t i = 0; i < edges.size(); ++i)
+	{
+		if (keep[i])
+			edges[j++] = edges[i];
+	}
+	edges.resize(j);
+}
+
+void removeParallelEdges(EdgeList& edges, const BasicNetwork& net)
+{
+	removeParallelEdges(edges);
+	if (net.numberOfLinks() == 0)
+		return;
+	id_size_t j = 0;
+	for (id_size_t i = 0; i < edges.size(); ++i)
+	{
+		if (!net.isLink(edges[i].first, edges[i].second).first)
+			edges[j++] = edges[i];
+	}
+	edges.resize(j);
+}
+
+NetworkBuilder::NetworkBuilder(const id_size_t nNodes,
+		const node_state_size_t nNodeStates) :
+	states_(nNodes, 0), nNodeStates_(nNodeStates > 0 ? nNodeStates : 1),
+			removeParallel_(false)
+{
+}
+
+void NetworkBuilder::build(BasicNetwork& net, LinkStateCalculator* lsCalc) const
+{
+	EdgeList unique;
+	if (removeParallel_)
+	{
+		unique = edges_;
+		removeParallelEdges(unique);
+	}
+	const EdgeList& edges = removeParallel_ ? unique : edges_;
+
+	net.reset(states_.size(), edges.size(), nNodeStates_, lsCalc);
+	// nodes are still isolated, so no link states need to be recalculated
+	for (node_id_t n = 0; n < states_.size(); ++n)
+	{
+		if (states_[n] != 0)
+			net.setNodeState(n, states_[n]);
+	}
+	net.addLinks(edges);
+}
+
+void NetworkBuilder::clear()
+{
+	states_.clear();
+	edges_.clear();
+}
+
+}
@@ -0,0 +1,210 @@
+/**
+ * This work is licensed under the Creative Commons
+ * Attribution-NonCommercial 3.0 Unported License. To view a copy of this
+ * license, visit http://creativecommons.org/licenses/by-nc/3.0/ or send a
+ * letter to Creative Commons, 444 Castro Street, Suite 900, Mountain View,
+ * California, 94041, USA.
+ */
+/**
+ * @file NetworkBuilder.h
+ * Declaration of the lnet::NetworkBuilder class.
+ */
+#ifndef NETWORKBUILDER_H_
+#define NETWORKBUILDER_H_
+
+#include <largenet/base/types.h>
+#include <largenet/base/state_calculators.h>
+#include <largenet/base/BasicNetwork.h>
+#include <vector>
+#include <cassert>
+
+namespace lnet
+{
+
+/**
+ * Remove parallel edges from @p edges, keeping the first of each set of
+ * parallel edges and the order of the remaining ones. Edges (a, b) and (b, a)
+ * are parallel, as for Network. Takes O(N + L) time for the largest node ID
+ * N and L edges.
+ * @param[in,out] edges List of (source, target) pairs.
+ */
+void removeParallelEdges(EdgeList& edges);
+/**
+ * Same as removeParallelEdges(EdgeList&), but also removes edges parallel to
+ * links already in @p net.
+ * @param[in,out] edges List of (source, target) pairs.
+ * @param net Network the edges are to be added to.
+ */
+void removeParallelEdges(EdgeList& edges, const BasicNetwork& net);
+
+/**
+ * Collects nodes, node states and links, and fills a network with them in
+ * one go.
+ *
+ * Adding links one by one to a network updates the link store and the node
+ * link lists for each link, and Network checks for an existing link every
+ * time. build() instead resets the network to exactly the collected number
+ * of nodes and links, sets node states while all nodes are isolated, and adds
+ * all links with BasicNetwork::addLinks(). This takes O(N + L) time.
+ *
+ * @code
+ * NetworkBuilder b(n, 2);
+ * b.setNodeState(0, 1);
+ * b.addLink(0, 1);
+ * ...
+ * b.build(net);
+ * @endcode
+ *
+ * Nodes get IDs 0 to numberOfNodes() - 1. If the network refuses parallel
+ * links (Network), they are dropped; for other networks, they are kept
+ * unless setRemoveParallelLinks() is used.
+ */
+class NetworkBuilder
+{
+public:
+	/**
+	 * Constructor.
+	 * @param nNodes Number of nodes, all of them in state 0.
+	 * @param nNodeStates Number of node states.
+	 */
+	NetworkBuilder(id_size_t nNodes = 0, node_state_size_t nNodeStates = 1);
+
+	/**
+	 * Add a node in state @p s.
+	 * @param s %Node state.
+	 * @return ID the node will have in the network.
+	 */
+	node_id_t addNode(node_state_t s = 0);
+	/**
+	 * Put node @p n in state @p s. The number of node states is increased if
+	 * necessary.
+	 * @param n %Node ID, must be smaller than numberOfNodes().
+	 * @param s %Node state.
+	 */
+	void setNodeState(node_id_t n, node_state_t s);
+	/**
+	 * Add a link from @p source to @p target. The number of nodes is
+	 * increased if necessary.
+	 * @param source Source node ID.
+	 * @param target Target node ID.
+	 */
+	void addLink(node_id_t source, node_id_t target);
+	/**
+	 * Allocate room for @p n links.
+	 * @param n Number of links.
+	 */
+	void reserveLinks(id_size_t n);
+	/**
+	 * Choose whether build() drops parallel links, even if the network
+	 * allows them. Off by default.
+	 * @param remove True to drop parallel links.
+	 */
+	void setRemoveParallelLinks(bool remove = true);
+
+	/**
+	 * Return number of nodes.
+	 */
+	id_size_t numberOfNodes() const;
+	/**
+	 * Return number of links added so far, including parallel ones.
+	 */
+	id_size_t numberOfLinks() const;
+	/**
+	 * Return number of node states.
+	 */
+	node_state_size_t numberOfNodeStates() const;
+	/**
+	 * Return state of node @p n.
+	 * @param n %Node ID.
+	 */
+	node_state_t nodeState(node_id_t n) const;
+	/**
+	 * Return the links added so far, in order.
+	 */
+	const EdgeList& links() const;
+
+	/**
+	 * Replace the contents of @p net by the collected nodes and links. @p net
+	 * is reset, so that its stores are allocated exactly once.
+	 * @param net Network to fill.
+	 * @param lsCalc Link state calculator for @p net (see
+	 * BasicNetwork::reset()).
+	 */
+	void build(BasicNetwork& net, LinkStateCalculator* lsCalc = 0) const;
+
+	/**
+	 * Remove all nodes and links.
+	 */
+	void clear();
+
+private:
+	std::vector<node_state_t> states_; ///< node states, indexed by node ID
+	EdgeList edges_; ///< links in order of addition
+	node_state_size_t nNodeStates_;
+	bool removeParallel_;
+};
+
+inline node_id_t NetworkBuilder::addNode(const node_state_t s)
+{
+	states_.push_back(0);
+	setNodeState(states_.size() - 1, s);
+	return states_.size() - 1;
+}
+
+inline void NetworkBuilder::setNodeState(const node_id_t n,
+		const node_state_t s)
+{
+	assert(n < states_.size());
+	states_[n] = s;
+	if (s >= nNodeStates_)
+		nNodeStates_ = s + 1;
+}
+
+inline void NetworkBuilder::addLink(const node_id_t source,
+		const node_id_t target)
+{
+	const node_id_t m = (source < target) ? target : source;
+	if (m >= states_.size())
+		states_.resize(m + 1, 0);
+	edges_.push_back(std::make_pair(source, target));
+}
+
+inline void NetworkBuilder::reserveLinks(const id_size_t n)
+{
+	edges_.reserve(n);
+}
+
+inline void NetworkBuilder::setRemoveParallelLinks(const bool remove)
+{
+	removeParallel_ = remove;
+}
+
+inline id_size_t NetworkBuilder::numberOfNodes() const
+{
+	return states_.size();
+}
+
+inline id_size_t NetworkBuilder::numberOfLinks() const
+{
+	return edges_.size();
+}
+
+inline node_state_size_t NetworkBuilder::numberOfNodeStates() const
+{
+	return nNodeStates_;
+}
+
+inline node_state_t NetworkBuilder::nodeState(const node_id_t n) const
+{
+	assert(n < states_.size());
+	return states_[n];
+}
+
+inline const EdgeList& NetworkBuilder::links() const
+{
+	return edges_;
+}
+
+}
+
+#endif /* NETWORKBUILDER_H_ */
@@ -0,0 +1,36 @@
+/**
+ * This work is licensed under the Creative Commons
+ * Attribution-NonCommercial 3.0 Unported License. To view a copy of this
+ * license, visit http://creativecommons.org/licenses/by-nc/3.0/ or send a
+ * letter to Creative Commons, 444 Castro Street, Suite 900, Mountain View,
+ * California, 94041, USA.
+ */
+
+/**
+ * @file PartitionedMultiNetwork.h
+ * Declaration of the lnet::PartitionedMultiNetwork class.
+ */
+#ifndef PARTITIONEDMULTINETWORK_H_
+#define PARTITIONEDMULTINETWORK_H_
+
+#include <largenet/base/PartitionedNode.h>
+#include <largenet/base/FlatLink.h>
+#include <largenet/base/TypedNetwork.h>
+
+namespace lnet
+{
+
+/**
+ * A MultiNetwork whose nodes keep their adjacent links grouped by the state of
+ * the neighbor (see PartitionedNode). Drawing a random neighbor in a given
+ * node state and counting neighbors in a given state take constant time, and
+ * drawing a random adjacent link in a given link state takes time linear in
+ * the number of node states. In exchange, adding or removing a link takes
+ * time linear in the number of node states, and a state change of a node
+ * regroups its entries in the link lists of all its neighbors.
+ */
+typedef TypedNetwork<PartitionedNode, FlatLink> PartitionedMultiNetwork;
+
+}
+
+#endif /* PARTITIONEDMULTINETWORK_H_ */
@@ -13,6 +13,7 @@
 
 #include "TripleMultiNetwork.h"
 #include <vector>
+#include <algorithm>
 #include <stdexcept>
 
 namespace lnet
@@ -20,27 +21,33 @@ namespace lnet
 
 TripleMultiNetwork::TripleMultiNetwork() :
 		TypedNetwork<NodeType, LinkType>(), tripleStore_(new TripleRepo(1, 0)), tsCalc_(
-				new DefaultTripleStateCalculator(1)), tscOwn_(true)
+				new DefaultTripleStateCalculator(1)), tscOwn_(true), tsTable_(0), centerCounts_(
+				0)
 {
+	bindTripleStateCalculator();
 }
 
 TripleMultiNetwork::TripleMultiNetwork(const id_size_t nNodes,
 		const id_size_t nLinks, const node_state_size_t nNodeStates,
 		LinkStateCalculator* lsCalc, TripleStateCalculator* tsCalc) :
 		TypedNetwork<NodeType, LinkType>(nNodes, nLinks, nNodeStates, lsCalc), tripleStore_(
-				0), tsCalc_(tsCalc), tscOwn_(false)
+				0), tsCalc_(tsCalc), tscOwn_(false), tsTable_(0), centerCounts_(0)
 {
 	if (tsCalc_ == 0)
 	{
 		tsCalc_ = new DefaultTripleStateCalculator(nNodeStates);
 		tscOwn_ = true;
 	}
+	bindTripleStateCalculator();
 	tripleStore_ = new TripleRepo(tsCalc_->numberOfTripleStates(), 0);
 }
 
 TripleMultiNetwork::TripleMultiNetwork(const TripleMultiNetwork& net) :
-		TypedNetwork<NodeType, LinkType>::TypedNetwork(net), tsCalc_(0), tscOwn_(
-				false)
+		TypedNetwork<NodeType, LinkType>::TypedNetwork(net), tripleStore_(
+				new TripleRepo(*net.tripleStore_)), tsCalc_(0), tscOwn_(false), tsTable_(
+				0), centerCounts_(
+				net.centerCounts_ ? new TripleCenterCounts(*net.centerCounts_) : 0), tripleGroups_(
+				net.tripleGroups_)
 {
 	if (net.tscOwn_)
 	{
@@ -52,11 +59,13 @@ TripleMultiNetwork::TripleMultiNetwork(const TripleMultiNetwork& net) :
 		tsCalc_ = net.tsCalc_;
 		tscOwn_ = false;
 	}
+	bindTripleStateCalculator();
 }
 
 TripleMultiNetwork::~TripleMultiNetwork()
 {
 	delete tripleStore_;
+	delete centerCounts_;
 	if (tscOwn_)
 		delete tsCalc_;
 }
@@ -70,31 +79,181 @@ void TripleMultiNetwork::doReset(id_size_t nNodes, id_size_t nLinks,
 		delete tsCalc_;
 	tsCalc_ = new DefaultTripleStateCalculator(nNodeStates);
 	tscOwn_ = true;
+	bindTripleStateCalculator();
 	delete tripleStore_;
 	tripleStore_ = new TripleRepo(tsCalc_->numberOfTripleStates());
+	tripleGroups_.clear();
+	if (centerCounts_)
+		rebuildCenterCounts();
 }
 
 void TripleMultiNetwork::setTripleStateCalculator(TripleStateCalculator* tsCalc)
 {
+	if ((tsCalc != 0) && !isValidTripleStateCalculator(tsCalc))
+		throw(std::invalid_argument(
+				"TripleStateCalculator gives impossible triple states!"));
+	if (centerCounts_ && (tsCalc != 0) && !TripleCenterCounts::isSymmetric(
+			*tsCalc, numberOfNodeStates()))
+		throw(std::invalid_argument(
+				"TripleStateCalculator distinguishes left and right nodes!"));
 	if (tscOwn_)
-	{
 		delete tsCalc_;
-		tscOwn_ = false;
-	}
 	if (tsCalc != 0)
 	{
-		if (isValidTripleStateCalculator(tsCalc))
-			tsCalc_ = tsCalc;
-		else
-			throw(std::invalid_argument(
-					"TripleStateCalculator gives impossible triple states!"));
+		tsCalc_ = tsCalc;
+		tscOwn_ = false;
 	}
 	else
 	{
 		tsCalc_ = new DefaultTripleStateCalculator(numberOfNodeStates());
 		tscOwn_ = true;
 	}
+	bindTripleStateCalculator();
+	if (centerCounts_)
+		rebuildCenterCounts();
+}
+
+void TripleMultiNetwork::enableImplicitTriples(const bool enable)
+{
+	if (enable == (centerCounts_ != 0))
+		return;
+	if (enable)
+	{
+		if (!TripleCenterCounts::isSymmetric(*tsCalc_, numberOfNodeStates()))
+			throw(std::invalid_argument(
+					"TripleStateCalculator distinguishes left and right nodes!"));
+		LinkIteratorRange iters = links();
+		for (LinkIterator it = iters.first; it != iters.second; ++it)
+		{
+			if (!fitsImplicitTripleID(*it))
+				throw(std::length_error(
+						"Link IDs are too large for implicit triples!"));
+		}
+		for (LinkIterator& it = iters.first; it != iters.second; ++it)
+			link(*it).clear();
+		tripleStore_->removeAll();
+		enableNeighborStateCounts();
+		rebuildCenterCounts();
+	}
+	else
+	{
+		delete centerCounts_;
+		centerCounts_ = 0;
+		// create the triples as if the links had been added in order of
+		// their IDs
+		std::vector<link_id_t> all;
+		all.reserve(numberOfLinks());
+		LinkIteratorRange iters = links();
+		all.assign(iters.first, iters.second);
+		std::sort(all.begin(), all.end());
+		addTriples(all);
+	}
+}
+
+void TripleMultiNetwork::rebuildCenterCounts()
+{
+	delete centerCounts_;
+	centerCounts_ = new TripleCenterCounts(*tsCalc_, numberOfNodeStates());
+	id_size_t size = 0;
+	NodeIteratorRange nodeIters = nodes();
+	for (NodeIterator& it = nodeIters.first; it != nodeIters.second; ++it)
+	{
+		if (*it >= size)
+			size = *it + 1;
+	}
+	centerCounts_->reset(size);
+	LinkIteratorRange linkIters = links();
+	for (LinkIterator& it = linkIters.first; it != linkIters.second; ++it)
+	{
+		if (source(*it) == target(*it))
+			centerCounts_->addSelfLoop(source(*it));
+	}
+	nodeIters = nodes();
+	for (NodeIterator& it = nodeIters.first; it != nodeIters.second; ++it)
+		updateCenter(*it);
+}
+
+void TripleMultiNetwork::updateCenter(const node_id_t n)
+{
+	neighborStates_.resize(numberOfNodeStates());
+	for (node_state_t s = 0; s < numberOfNodeStates(); ++s)
+		neighborStates_[s] = neighborsInState(n, s);
+	centerCounts_->update(n, nodeState(n), neighborStates_);
+}
+
+triple_id_t TripleMultiNetwork::implicitTriple(const triple_state_t s,
+		const id_size_t x) const
+{
+	node_id_t c;
+	node_state_t a, b;
+	centerCounts_->locate(s, x, c, a, b);
+	const id_size_t na = neighborsInState(c, a), nb =
+			(a == b) ? na - 1 : neighborsInState(c, b);
+	link_id_t la = 0, lb = 0;
+	do
+	{
+		// take the i'th link to a neighbor in state a and the j'th link to
+		// a neighbor in state b, skipping the i'th one if a == b
+		const id_size_t i = rng.IntFromTo(static_cast<id_size_t>(0), na - 1);
+		id_size_t j = rng.IntFromTo(static_cast<id_size_t>(0), nb - 1);
+		if ((a == b) && (j >= i))
+			++j;
+		id_size_t ka = 0, kb = 0;
+		NeighborLinkIteratorRange iters = neighborLinks(c);
+		for (NeighborLinkIterator& it = iters.first; it != iters.second; ++it)
+		{
+			const node_state_t ns = nodeState(it.neighbor());
+			if (ns == a)
+			{
+				if (ka == i)
+					la = *it;
+				if ((a == b) && (ka == j))
+					lb = *it;
+				++ka;
+			}
+			else if (ns == b)
+			{
+				if (kb == j)
+					lb = *it;
+				++kb;
+			}
+			if ((ka > i) && (((a == b) ? ka : kb) > j))
+				break;
+		}
+	} while (la == lb); // the two ends of a self-loop
+	return implicitTripleID(la, lb);
+}
 
+void TripleMultiNetwork::bindTripleStateCalculator()
+{
+	tsTable_ = dynamic_cast<const TripleStateTable*>(tsCalc_);
+}
+
+void TripleMultiNetwork::doCompact(IDMap& map)
+{
+	TypedNetwork<NodeType, LinkType>::doCompact(map);
+	map.triples = tripleStore_->compact();
+	std::vector<triple_id_t> temp;
+	LinkIteratorRange linkIters = links();
+	for (LinkIterator& it = linkIters.first; it != linkIters.second; ++it)
+	{
+		LinkType& theLink = link(*it);
+		NeighborTripleIteratorRange iters = theLink.triples();
+		temp.assign(iters.first, iters.second);
+		theLink.clear();
+		for (std::vector<triple_id_t>::const_iterator ti = temp.begin(); ti
+				!= temp.end(); ++ti)
+			theLink.addTriple(map.triples[*ti]);
+	}
+	TripleIteratorRange tripleIters = triples();
+	for (TripleIterator& it = tripleIters.first; it != tripleIters.second; ++it)
+	{
+		Triple& t = triple(*it);
+		t.setLeft(map.links[t.left()]);
+		t.setRight(map.links[t.right()]);
+	}
+	if (centerCounts_)
+		rebuildCenterCounts();
 }
 
 bool TripleMultiNetwork::isValidTripleStateCalculator(
@@ -138,6 +297,17 @@ node_id_t TripleMultiNetwork::centerNode(const triple_id_t t) const
 void TripleMultiNetwork::onNodeStateChange(const node_id_t n)
 {
 	TypedNetwork<NodeType, LinkType>::onNodeStateChange(n);
+	if (centerCounts_)
+	{
+		updateCenter(n);
+		NeighborLinkIteratorRange iters = neighborLinks(n);
+		for (NeighborLinkIterator& it = iters.first; it != iters.second; ++it)
+		{
+			if (it.neighbor() != n)
+				updateCenter(it.neighbor());
+		}
+		return;
+	}
 	NeighborLinkIteratorRange iters = neighborLinks(n);
 	for (NeighborLinkIterator& it = iters.first; it != iters.second; ++it)
 	{
@@ -146,16 +316,77 @@ void TripleMultiNetwork::onNodeStateChange(const node_id_t n)
 				++nit)
 		{
 			tripleStore_->setCategory(*nit,
-					(*tsCalc_)(nodeState(leftNode(*nit)),
+					calcTripleState(nodeState(leftNode(*nit)),
 							nodeState(centerNode(*nit)),
 							nodeState(rightNode(*nit))));
 		}
 	}
 }
 
+void TripleMultiNetwork::onNodeStatesChange(const std::vector<node_id_t>& nodes)
+{
+	std::vector<link_id_t> links;
+	collectNeighborLinks(nodes, links);
+	recalcLinkStatesOf(links);
+	if (centerCounts_)
+	{
+		// changed nodes without links have no triples
+		std::vector<node_id_t> centers;
+		centers.reserve(2 * links.size());
+		for (std::vector<link_id_t>::const_iterator it = links.begin();
+				it != links.end(); ++it)
+		{
+			centers.push_back(source(*it));
+			centers.push_back(target(*it));
+		}
+		std::sort(centers.begin(), centers.end());
+		centers.erase(std::unique(centers.begin(), centers.end()),
+				centers.end());
+		for (std::vector<node_id_t>::const_iterator it = centers.begin();
+				it != centers.end(); ++it)
+			updateCenter(*it);
+		return;
+	}
+
+	std::vector<triple_id_t> triples;
+	for (std::vector<link_id_t>::const_iterator it = links.begin();
+			it != links.end(); ++it)
+	{
+		NeighborTripleIteratorRange niters = neighborTriples(*it);
+		triples.insert(triples.end(), niters.first, niters.second);
+	}
+	// each triple is reached through both of its links
+	std::sort(triples.begin(), triples.end());
+	triples.erase(std::unique(triples.begin(), triples.end()), triples.end());
+
+	std::vector<triple_state_t> states;
+	states.reserve(triples.size());
+	for (std::vector<triple_id_t>::const_iterator it = triples.begin();
+			it != triples.end(); ++it)
+	{
+		states.push_back(calcTripleState(nodeState(leftNode(*it)),
+				nodeState(centerNode(*it)), nodeState(rightNode(*it))));
+	}
+	tripleStore_->setCategories(triples.begin(), triples.end(), states.begin());
+}
+
 std::pair<bool, triple_id_t> TripleMultiNetwork::randomTriple() const
 {
 	std::pair<bool, triple_id_t> ret = std::make_pair(false, 0);
+	if (centerCounts_)
+	{
+		const id_size_t n = centerCounts_->count();
+		if (n > 0)
+		{
+			id_size_t x = rng.IntFromTo(static_cast<id_size_t>(0), n - 1);
+			triple_state_t s = 0;
+			while (x >= centerCounts_->count(s))
+				x -= centerCounts_->count(s++);
+			ret.first = true;
+			ret.second = implicitTriple(s, x);
+		}
+		return ret;
+	}
 	if (tripleStore_->size() > 0)
 	{
 		ret.first = true;
@@ -171,6 +402,17 @@ std::pair<bool, triple_id_t> TripleMultiNetwork::randomTriple(
 		const triple_state_t s) const
 {
 	std::pair<bool, triple_id_t> ret = std::make_pair(false, 0);
+	if (centerCounts_)
+	{
+		if (centerCounts_->count(s) > 0)
+		{
+			ret.first = true;
+			ret.second = implicitTriple(s,
+					rng.IntFromTo(static_cast<id_size_t>(0),
+							centerCounts_->count(s) - 1));
+		}
+		return ret;
+	}
 	if (tripleStore_->count(s) > 0)
 	{
 		ret.first = true;
@@ -182,9 +424,39 @@ std::pair<bool, triple_id_t> TripleMultiNetwork::randomTriple(
 	return ret;
 }
 
-void TripleMultiNetwork::addTriple(const link_id_t left, const link_id_t right)
+std::pair<bool, triple_id_t> TripleMultiNetwork::randomTriple(
+		const state_group_t g) const
+{
+	std::pair<bool, triple_id_t> ret = std::make_pair(false, 0);
+	if (centerCounts_)
+	{
+		const id_size_t n = numberOfTriples(g);
+		if (n > 0)
+		{
+			id_size_t x = rng.IntFromTo(static_cast<id_size_t>(0), n - 1);
+			std::vector<triple_state_t>::const_iterator s =
+					tripleGroups_[g.index].begin();
+			while (x >= centerCounts_->count(*s))
+				x -= centerCounts_->count(*s++);
+			ret.first = true;
+			ret.second = implicitTriple(*s, x);
+		}
+		return ret;
+	}
+	if (tripleStore_->count(g) > 0)
+	{
+		ret.first = true;
+		ret.second = tripleStore_->id(g,
+				static_cast<repo::address_t>(rng.IntFromTo(
+						static_cast<repo::id_size_t>(0),
+						tripleStore_->count(g) - 1)));
+	}
+	return ret;
+}
+
+void TripleMultiNetwork::tripleNodes(const link_id_t left,
+		const link_id_t right, node_id_t& l, node_id_t& c, node_id_t& r) const
 {
-	node_id_t l, c, r;
 	if (target(left) == source(right))
 	{
 		l = source(left);
@@ -209,18 +481,127 @@ void TripleMultiNetwork::addTriple(const link_id_t left, const link_id_t right)
 		c = source(left);
 		r = source(right);
 	}
+}
 
+void TripleMultiNetwork::addTriple(const link_id_t left, const link_id_t right)
+{
+	node_id_t l, c, r;
+	tripleNodes(left, right, l, c, r);
 	const triple_id_t t = tripleStore_->insert(Triple(left, right),
-			(*tsCalc_)(nodeState(l), nodeState(c), nodeState(r)));
+			calcTripleState(nodeState(l), nodeState(c), nodeState(r)));
 	link(left).addTriple(t);
 	link(right).addTriple(t);
 }
 
+void TripleMultiNetwork::addTriples(const std::vector<link_id_t>& added)
+{
+	if (added.empty())
+		return;
+	// rank of the new links in order of addition, 0 for old links; as with
+	// doAddLink(), the later link of a triple becomes its left link
+	const link_id_t maxID = *std::max_element(added.begin(), added.end());
+	std::vector<id_size_t> rank(maxID + 1, 0);
+	for (id_size_t i = 0; i < added.size(); ++i)
+		rank[added[i]] = i + 1;
+
+	// new triples are centered at the end nodes of new links
+	std::vector<node_id_t> centers;
+	centers.reserve(2 * added.size());
+	for (std::vector<link_id_t>::const_iterator it = added.begin();
+			it != added.end(); ++it)
+	{
+		centers.push_back(source(*it));
+		centers.push_back(target(*it));
+	}
+	std::sort(centers.begin(), centers.end());
+	centers.erase(std::unique(centers.begin(), centers.end()), centers.end());
+
+	// counting pass: the triples of each center get their own slice, so that
+	// the centers can be handled independently of each other
+	std::vector<id_size_t> offsets(centers.size() + 1, 0);
+	for (id_size_t i = 0; i < centers.size(); ++i)
+	{
+		id_size_t k = 0, kOld = 0, loopEnds = 0;
+		NeighborLinkIteratorRange iters = neighborLinks(centers[i]);
+		for (NeighborLinkIterator& it = iters.first; it != iters.second; ++it)
+		{
+			++k;
+			if ((*it > maxID) || (rank[*it] == 0))
+				++kOld;
+			else if (it.neighbor() == centers[i])
+				++loopEnds;
+		}
+		// a self-loop is listed twice, but forms no triple with itself
+		offsets[i + 1] = offsets[i] + k * (k - 1) / 2 - kOld * (kOld - 1) / 2
+				- loopEnds / 2;
+	}
+
+	std::vector<Triple> items(offsets.back());
+	std::vector<triple_state_t> states(offsets.back());
+	std::vector<Adjacency> adj;
+	for (id_size_t i = 0; i < centers.size(); ++i)
+	{
+		const node_id_t c = centers[i];
+		adj.clear();
+		NeighborLinkIteratorRange iters = neighborLinks(c);
+		for (NeighborLinkIterator& it = iters.first; it != iters.second; ++it)
+			adj.push_back(Adjacency(it.neighbor(), *it));
+		id_size_t pos = offsets[i];
+		for (id_size_t a = 0; a < adj.size(); ++a)
+		{
+			const id_size_t ra = (adj[a].link > maxID) ? 0 : rank[adj[a].link];
+			for (id_size_t b = a + 1; b < adj.size(); ++b)
+			{
+				const id_size_t rb =
+						(adj[b].link > maxID) ? 0 : rank[adj[b].link];
+				if (((ra == 0) && (rb == 0)) || (adj[a].link == adj[b].link))
+					continue;
+				const Adjacency& left = (ra > rb) ? adj[a] : adj[b];
+				const Adjacency& right = (ra > rb) ? adj[b] : adj[a];
+				node_id_t l = left.neighbor, cc = c, r = right.neighbor;
+				// parallel links share both nodes; pick the center as
+				// addTriple() does
+				if (l == r)
+					tripleNodes(left.link, right.link, l, cc, r);
+				items[pos] = Triple(left.link, right.link);
+				states[pos] = calcTripleState(nodeState(l), nodeState(cc),
+						nodeState(r));
+				++pos;
+			}
+		}
+		assert(pos == offsets[i + 1]);
+	}
+
+	std::vector<triple_id_t> ids(items.size());
+	tripleStore_->insertBulk(items.begin(), items.end(), states.begin(),
+			ids.begin());
+	for (id_size_t k = 0; k < items.size(); ++k)
+	{
+		link(items[k].left()).addTriple(ids[k]);
+		link(items[k].right()).addTriple(ids[k]);
+	}
+}
+
 link_id_t TripleMultiNetwork::doAddLink(const node_id_t source,
 		const node_id_t target)
 {
 	const link_id_t l = TypedNetwork<NodeType, LinkType>::doAddLink(source,
 			target);
+	if (centerCounts_)
+	{
+		if (!fitsImplicitTripleID(l))
+		{
+			TypedNetwork<NodeType, LinkType>::doRemoveLink(l);
+			throw(std::length_error(
+					"Link IDs are too large for implicit triples!"));
+		}
+		if (source == target)
+			centerCounts_->addSelfLoop(source);
+		updateCenter(source);
+		if (target != source)
+			updateCenter(target);
+		return l;
+	}
 
 	// create a new triple for each adjacent link of source (except the newly created one)
 	NeighborLinkIteratorRange siters = neighborLinks(source);
@@ -242,6 +623,41 @@ link_id_t TripleMultiNetwork::doAddLink(const node_id_t source,
 	return l;
 }
 
+void TripleMultiNetwork::doAddLinks(const EdgeList& edges)
+{
+	std::vector<link_id_t> ids;
+	insertLinks(edges, ids);
+	if (centerCounts_)
+	{
+		if (!ids.empty() && !fitsImplicitTripleID(*std::max_element(
+				ids.begin(), ids.end())))
+		{
+			for (std::vector<link_id_t>::const_iterator it = ids.begin(); it
+					!= ids.end(); ++it)
+				TypedNetwork<NodeType, LinkType>::doRemoveLink(*it);
+			throw(std::length_error(
+					"Link IDs are too large for implicit triples!"));
+		}
+		std::vector<node_id_t> centers;
+		centers.reserve(2 * edges.size());
+		for (EdgeList::const_iterator e = edges.begin(); e != edges.end(); ++e)
+		{
+			if (e->first == e->second)
+				centerCounts_->addSelfLoop(e->first);
+			centers.push_back(e->first);
+			centers.push_back(e->second);
+		}
+		std::sort(centers.begin(), centers.end());
+		centers.erase(std::unique(centers.begin(), centers.end()),
+				centers.end());
+		for (std::vector<node_id_t>::const_iterator it = centers.begin();
+				it != centers.end(); ++it)
+			updateCenter(*it);
+		return;
+	}
+	addTriples(ids);
+}
+
 void TripleMultiNetwork::removeTriplesFromLinkEnd(const link_id_t l,
 		const bool fromSource)
 {
@@ -259,7 +675,7 @@ void TripleMultiNetwork::removeTriplesFromLinkEnd(const link_id_t l,
 			if ((*nit != l) && triple(*it).containsLink(*nit))
 			{
 				link(*nit).removeTriple(*it);
-				temp.push_back(*nit);
+				temp.push_back(*it);
 			}
 		}
 	}
@@ -274,6 +690,25 @@ void TripleMultiNetwork::removeTriplesFromLinkEnd(const link_id_t l,
 bool TripleMultiNetwork::doChangeLink(const link_id_t l, const node_id_t source,
 		const node_id_t target)
 {
+	if (centerCounts_)
+	{
+		node_id_t ends[4] = { link(l).source(), link(l).target(), source,
+				target };
+		if (ends[0] == ends[1])
+			centerCounts_->removeSelfLoop(ends[0]);
+		const bool retval = TypedNetwork<NodeType, LinkType>::doChangeLink(l,
+				source, target);
+		if (source == target)
+			centerCounts_->addSelfLoop(source);
+		std::sort(ends, ends + 4);
+		for (int i = 0; i < 4; ++i)
+		{
+			if ((i == 0) || (ends[i] != ends[i - 1]))
+				updateCenter(ends[i]);
+		}
+		return retval;
+	}
+
 	bool retval = true, source_changed = false, target_changed = false;
 	if (link(l).source() != source)
 	{
@@ -289,6 +724,19 @@ bool TripleMultiNetwork::doChangeLink(const link_id_t l, const node_id_t source,
 	// now change the link, updating its state
 	retval &= TypedNetwork<NodeType, LinkType>::doChangeLink(l, source, target);
 
+	// the remaining triples, centered at the unchanged end, have a new outer node
+	if (source_changed != target_changed)
+	{
+		NeighborTripleIteratorRange iters = neighborTriples(l);
+		for (NeighborTripleIterator& it = iters.first; it != iters.second; ++it)
+		{
+			tripleStore_->setCategory(*it,
+					calcTripleState(nodeState(leftNode(*it)),
+							nodeState(centerNode(*it)),
+							nodeState(rightNode(*it))));
+		}
+	}
+
 	// and add the newly created triples accordingly
 	if (source_changed)
 	{
@@ -315,6 +763,17 @@ bool TripleMultiNetwork::doChangeLink(const link_id_t l, const node_id_t source,
 
 void TripleMultiNetwork::doRemoveLink(const link_id_t l)
 {
+	if (centerCounts_)
+	{
+		const node_id_t s = source(l), t = target(l);
+		TypedNetwork<NodeType, LinkType>::doRemoveLink(l);
+		if (s == t)
+			centerCounts_->removeSelfLoop(s);
+		updateCenter(s);
+		if (t != s)
+			updateCenter(t);
+		return;
+	}
 	// delete each triple this link is a part of and update neighboring links accordingly
 	NeighborTripleIteratorRange iters = neighborTriples(l);
 	for (NeighborTripleIterator& it = iters.first; it != iters.second; ++it)
@@ -338,10 +797,31 @@ void TripleMultiNetwork::doRemoveAllLinks()
 	tripleStore_->removeAll();
 	// now really delete all links and update nodes accordingly
 	TypedNetwork<NodeType, LinkType>::doRemoveAllLinks();
+	if (centerCounts_)
+		rebuildCenterCounts();
 }
 
 void TripleMultiNetwork::doRemoveNode(const node_id_t n)
 {
+	if (centerCounts_)
+	{
+		std::vector<node_id_t> neighbors;
+		NeighborLinkIteratorRange iters = neighborLinks(n);
+		for (NeighborLinkIterator& it = iters.first; it != iters.second; ++it)
+		{
+			if (it.neighbor() != n)
+				neighbors.push_back(it.neighbor());
+		}
+		std::sort(neighbors.begin(), neighbors.end());
+		neighbors.erase(std::unique(neighbors.begin(), neighbors.end()),
+				neighbors.end());
+		TypedNetwork<NodeType, LinkType>::doRemoveNode(n);
+		centerCounts_->clear(n);
+		for (std::vector<node_id_t>::const_iterator it = neighbors.begin();
+				it != neighbors.end(); ++it)
+			updateCenter(*it);
+		return;
+	}
 	// remove all triples containing this node
 	NeighborLinkIteratorRange iters = neighborLinks(n);
 	for (NeighborLinkIterator& it = iters.first; it != iters.second; ++it)
@@ -19,7 +19,9 @@
 #include <largenet/base/TLink.h>
 #include <largenet/base/Triple.h>
 #include <largenet/base/TypedNetwork.h>
+#include <largenet/base/TripleCenterCounts.h>
 #include <largenet/base/repo/CategorizedRepository.h>
+#include <vector>
 #include <cassert>
 
 namespace lnet
@@ -56,10 +58,49 @@ public:
 	triple_state_size_t numberOfTripleStates() const;
 	id_size_t numberOfTriples() const;
 	id_size_t numberOfTriples(triple_state_t s) const;
+	state_group_t addTripleStateGroup(const std::vector<triple_state_t>& states);
+	id_size_t numberOfTriples(state_group_t g) const;
 
 	void setTripleStateCalculator(TripleStateCalculator* tsCalc);
 	const TripleStateCalculator& getTripleStateCalculator() const;
 
+	/**
+	 * Switch between stored and implicit triples.
+	 *
+	 * By default, each triple is an item of the triple store and is
+	 * referenced by both of its links, which takes memory proportional to
+	 * the sum of k(k-1)/2 over all node degrees k. Implicit triples are not
+	 * stored; instead, the number of triples centered at each node is kept
+	 * for each triple state (see TripleCenterCounts) and recounted from the
+	 * neighbor state counts when links or node states change. The neighbor
+	 * state counts are enabled, too.
+	 *
+	 * With implicit triples, numberOfTriples() and randomTriple() work as
+	 * before. randomTriple() draws a center node weighted by its number of
+	 * triples in the requested state, and then two of its links, in time
+	 * linear in the degree of the center node. The triple ID returned
+	 * encodes the two links and is only valid until the network changes;
+	 * pass it to left(), right(), leftNode(), centerNode() or rightNode().
+	 * triples(), tripleIDs() and neighborTriples() give empty ranges.
+	 *
+	 * Implicit triples need a triple state calculator that gives the same
+	 * state for (a, b, c) and (c, b, a), such as the default one. Since a
+	 * triple ID holds both link IDs, link IDs must fit into half of a
+	 * triple_id_t, i.e. be below 2^32 if long has 64 bits and below 2^16
+	 * if it has 32 bits. Adding a link that would get a larger ID throws
+	 * std::length_error and leaves the network unchanged.
+	 * @param enable True for implicit triples, false to store all triples.
+	 * @throw std::invalid_argument if @p enable is true and the triple state
+	 * calculator is not symmetric.
+	 * @throw std::length_error if @p enable is true and a link ID is too
+	 * large.
+	 */
+	void enableImplicitTriples(bool enable = true);
+	/**
+	 * Return true if triples are implicit (see enableImplicitTriples()).
+	 */
+	bool hasImplicitTriples() const;
+
 	link_id_t left(triple_id_t t) const;
 	link_id_t right(triple_id_t t) const;
 
@@ -69,11 +110,13 @@ public:
 
 	TripleIteratorRange triples() const;
 	TripleStateIteratorRange triples(triple_state_t s) const;
+	IDSpan tripleIDs(triple_state_t s) const;
 
 	NeighborTripleIteratorRange neighborTriples(link_id_t l) const;
 
 	std::pair<bool, triple_id_t> randomTriple() const;
 	std::pair<bool, triple_id_t> randomTriple(triple_state_t s) const;
+	std::pair<bool, triple_id_t> randomTriple(state_group_t g) const;
 
 protected:
 	/**
@@ -84,6 +127,14 @@ protected:
 	 * @return Unique ID of link created
 	 */
 	virtual link_id_t doAddLink(node_id_t source, node_id_t target);
+	/**
+	 * Add links between the node pairs in @p edges, creating their triples.
+	 * All links are inserted first; then the new triples are enumerated
+	 * once per center node and inserted into the triple store at once (see
+	 * addTriples()).
+	 * @param edges (source, target) pairs of node IDs.
+	 */
+	virtual void doAddLinks(const EdgeList& edges);
 
 	/**
 	 * Change link to connect the new @p source with the new @p target.
@@ -114,7 +165,15 @@ protected:
 	 */
 	virtual void doRemoveNode(node_id_t n);
 
+	/**
+	 * Renumber nodes, links and triples consecutively and update all
+	 * references between them.
+	 * @param[out] map Maps from old to new IDs.
+	 */
+	virtual void doCompact(IDMap& map);
+
 	virtual void onNodeStateChange(node_id_t n);
+	virtual void onNodeStatesChange(const std::vector<node_id_t>& nodes);
 
 	Triple& triple(triple_id_t t) const;
 	bool isValidTripleStateCalculator(TripleStateCalculator* tsCalc) const;
@@ -124,12 +183,59 @@ protected:
 
 private:
 	void addTriple(link_id_t left, link_id_t right);
+	/**
+	 * Create all triples containing at least one of the links in @p added,
+	 * in one pass over the link lists of their end nodes. Triple IDs may
+	 * differ from those given by adding the links one by one.
+	 * @param added IDs of new links, in order of addition.
+	 */
+	void addTriples(const std::vector<link_id_t>& added);
+	/**
+	 * Find left, center and right node of the triple of links @p left and
+	 * @p right.
+	 */
+	void tripleNodes(link_id_t left, link_id_t right, node_id_t& l,
+			node_id_t& c, node_id_t& r) const;
 	void removeTriplesFromLinkEnd(link_id_t l, bool fromSource);
+	/**
+	 * Count implicit triples from scratch.
+	 */
+	void rebuildCenterCounts();
+	/**
+	 * Recount the implicit triples centered at node @p n.
+	 */
+	void updateCenter(node_id_t n);
+	/**
+	 * Return the @p x 'th implicit triple in state @p s (see
+	 * TripleCenterCounts::locate()), with two random links of its center
+	 * node to neighbors in the located states.
+	 */
+	triple_id_t implicitTriple(triple_state_t s, id_size_t x) const;
+	static triple_id_t implicitTripleID(link_id_t left, link_id_t right);
+	/**
+	 * Return true if link ID @p l fits into half of a triple ID.
+	 */
+	static bool fitsImplicitTripleID(link_id_t l);
+	/**
+	 * Update the table fast path after tsCalc_ has changed.
+	 */
+	void bindTripleStateCalculator();
+	/**
+	 * Return the state of a triple with the given node states. Uses the
+	 * non-virtual TripleStateTable::lookup() if the triple state calculator
+	 * is table-driven (such as DefaultTripleStateCalculator).
+	 */
+	triple_state_t calcTripleState(node_state_t left, node_state_t center,
+			node_state_t right) const;
 
 protected:
 	TripleRepo* tripleStore_;
 	TripleStateCalculator* tsCalc_;
 	bool tscOwn_;
+	const TripleStateTable* tsTable_; ///< tsCalc_ if it is a TripleStateTable, else 0
+	TripleCenterCounts* centerCounts_; ///< triple counts if triples are implicit, else 0
+	std::vector<std::vector<triple_state_t> > tripleGroups_; ///< triple states of each state group
+	std::vector<id_size_t> neighborStates_; ///< scratch space for updateCenter()
 };
 
 inline triple_state_size_t TripleMultiNetwork::numberOfTripleStates() const
@@ -139,14 +245,44 @@ inline triple_state_size_t TripleMultiNetwork::numberOfTripleStates() const
 
 inline id_size_t TripleMultiNetwork::numberOfTriples() const
 {
+	if (centerCounts_)
+		return centerCounts_->count();
 	return tripleStore_->size();
 }
 
 inline id_size_t TripleMultiNetwork::numberOfTriples(const triple_state_t s) const
 {
+	if (centerCounts_)
+		return centerCounts_->count(s);
 	return tripleStore_->count(s);
 }
 
+inline state_group_t TripleMultiNetwork::addTripleStateGroup(
+		const std::vector<triple_state_t>& states)
+{
+	tripleGroups_.push_back(states);
+	return tripleStore_->addGroup(states.begin(), states.end());
+}
+
+inline id_size_t TripleMultiNetwork::numberOfTriples(const state_group_t g) const
+{
+	if (centerCounts_)
+	{
+		id_size_t n = 0;
+		const std::vector<triple_state_t>& states = tripleGroups_.at(g.index);
+		for (std::vector<triple_state_t>::const_iterator it = states.begin(); it
+				!= states.end(); ++it)
+			n += centerCounts_->count(*it);
+		return n;
+	}
+	return tripleStore_->count(g);
+}
+
+inline bool TripleMultiNetwork::hasImplicitTriples() const
+{
+	return centerCounts_ != 0;
+}
+
 inline TripleMultiNetwork::NeighborTripleIteratorRange TripleMultiNetwork::neighborTriples(
 		const link_id_t l) const
 {
@@ -164,18 +300,51 @@ inline TripleMultiNetwork::TripleStateIteratorRange TripleMultiNetwork::triples(
 	return tripleStore_->ids(s);
 }
 
+inline TripleMultiNetwork::IDSpan TripleMultiNetwork::tripleIDs(
+		const triple_state_t s) const
+{
+	return tripleStore_->idSpan(s);
+}
+
+inline triple_state_t TripleMultiNetwork::calcTripleState(
+		const node_state_t left, const node_state_t center,
+		const node_state_t right) const
+{
+	return tsTable_ ? tsTable_->lookup(left, center, right) :
+			(*tsCalc_)(left, center, right);
+}
+
 inline Triple& TripleMultiNetwork::triple(const triple_id_t t) const
 {
 	return (*tripleStore_)[t];
 }
 
+inline triple_id_t TripleMultiNetwork::implicitTripleID(const link_id_t left,
+		const link_id_t right)
+{
+	// left link in the upper, right link in the lower half
+	assert(fitsImplicitTripleID(left) && fitsImplicitTripleID(right));
+	return (static_cast<triple_id_t>(left) << (sizeof(triple_id_t) * 4))
+			| right;
+}
+
+inline bool TripleMultiNetwork::fitsImplicitTripleID(const link_id_t l)
+{
+	return (l >> (sizeof(triple_id_t) * 4)) == 0;
+}
+
 inline link_id_t TripleMultiNetwork::left(const triple_id_t t) const
 {
+	if (centerCounts_)
+		return t >> (sizeof(triple_id_t) * 4);
 	return triple(t).left();
 }
 
 inline link_id_t TripleMultiNetwork::right(const triple_id_t t) const
 {
+	if (centerCounts_)
+		return t & ((static_cast<triple_id_t>(1) << (sizeof(triple_id_t) * 4))
+				- 1);
 	return triple(t).right();
 }
 
@@ -12,6 +12,7 @@
  */
 
 #include "TripleNetwork.h"
+#include "NetworkBuilder.h"
 
 namespace lnet
 {
@@ -53,6 +54,13 @@ link_id_t TripleNetwork::doAddLink(const node_id_t source,
 	return l;
 }
 
+void TripleNetwork::doAddLinks(const EdgeList& edges)
+{
+	EdgeList unique(edges);
+	removeParallelEdges(unique, *this);
+	TripleMultiNetwork::doAddLinks(unique);
+}
+
 bool TripleNetwork::doChangeLink(const link_id_t l, const node_id_t source,
 		const node_id_t target)
 {
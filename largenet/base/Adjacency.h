@@ -0,0 +1,180 @@
+/**
+ * This work is licensed under the Creative Commons
+ * Attribution-NonCommercial 3.0 Unported License. To view a copy of this
+ * license, visit http://creativecommons.org/licenses/by-nc/3.0/ or send a
+ * letter to Creative Commons, 444 Castro Street, Suite 900, Mountain View,
+ * California, 94041, USA.
+ */
+/**
+ * @file Adjacency.h
+ * Entries of a node's link list and iterators over them.
+ */
+#ifndef ADJACENCY_H_
+#define ADJACENCY_H_
+
+#include <largenet/base/types.h>
+#include <iterator>
+#include <cstddef>
+
+namespace lnet
+{
+
+/**
+ * Entry in a node's link list: the ID of an adjacent link together with the
+ * ID of the node at its other end. For a self-loop, the neighbor is the node
+ * itself. Storing the neighbor avoids looking up the link when iterating over
+ * neighbors.
+ */
+struct Adjacency
+{
+	Adjacency() :
+		neighbor(0), link(0)
+	{
+	}
+	Adjacency(const node_id_t n, const link_id_t l) :
+		neighbor(n), link(l)
+	{
+	}
+	/// Neighbor node ID. Not part of the ordering, so it may be changed in sets.
+	mutable node_id_t neighbor;
+	link_id_t link; ///< %Link ID
+};
+
+/**
+ * Ordering of Adjacency entries by link ID only.
+ */
+struct AdjacencyLinkOrder
+{
+	bool operator()(const Adjacency& a, const Adjacency& b) const
+	{
+		return a.link < b.link;
+	}
+};
+
+/**
+ * Iterator over a node's link list that dereferences to link IDs, so that it
+ * can be used wherever a plain link ID iterator is expected. The neighbor
+ * stored with the current entry is available through neighbor().
+ *
+ * The iterator category is that of the underlying iterator @p _It. Random
+ * access operations can only be used if @p _It supports them.
+ */
+template<class _It>
+class AdjacencyIterator: public std::iterator<
+		typename std::iterator_traits<_It>::iterator_category, link_id_t,
+		std::ptrdiff_t, const link_id_t*, const link_id_t&>
+{
+public:
+	typedef std::ptrdiff_t difference_type;
+
+	AdjacencyIterator() :
+		cur_()
+	{
+	}
+	explicit AdjacencyIterator(const _It it) :
+		cur_(it)
+	{
+	}
+
+	/**
+	 * Dereference operator.
+	 * @return Current link ID.
+	 */
+	const link_id_t& operator*() const
+	{
+		return cur_->link;
+	}
+	const link_id_t* operator->() const
+	{
+		return &cur_->link;
+	}
+	/**
+	 * Return the ID of the node at the other end of the current link.
+	 * @return Neighbor node ID.
+	 */
+	node_id_t neighbor() const
+	{
+		return cur_->neighbor;
+	}
+
+	AdjacencyIterator& operator++()
+	{
+		++cur_;
+		return *this;
+	}
+	AdjacencyIterator operator++(int)
+	{
+		AdjacencyIterator tmp(*this);
+		++cur_;
+		return tmp;
+	}
+	AdjacencyIterator& operator--()
+	{
+		--cur_;
+		return *this;
+	}
+	AdjacencyIterator operator--(int)
+	{
+		AdjacencyIterator tmp(*this);
+		--cur_;
+		return tmp;
+	}
+	AdjacencyIterator& operator+=(const difference_type n)
+	{
+		cur_ += n;
+		return *this;
+	}
+	AdjacencyIterator& operator-=(const difference_type n)
+	{
+		cur_ -= n;
+		return *this;
+	}
+	AdjacencyIterator operator+(const difference_type n) const
+	{
+		return AdjacencyIterator(cur_ + n);
+	}
+	AdjacencyIterator operator-(const difference_type n) const
+	{
+		return AdjacencyIterator(cur_ - n);
+	}
+	difference_type operator-(const AdjacencyIterator& it) const
+	{
+		return cur_ - it.cur_;
+	}
+	const link_id_t& operator[](const difference_type n) const
+	{
+		return cur_[n].link;
+	}
+
+	bool operator==(const AdjacencyIterator& it) const
+	{
+		return cur_ == it.cur_;
+	}
+	bool operator!=(const AdjacencyIterator& it) const
+	{
+		return cur_ != it.cur_;
+	}
+	bool operator<(const AdjacencyIterator& it) const
+	{
+		return cur_ < it.cur_;
+	}
+	bool operator>(const AdjacencyIterator& it) const
+	{
+		return cur_ > it.cur_;
+	}
+	bool operator<=(const AdjacencyIterator& it) const
+	{
+		return cur_ <= it.cur_;
+	}
+	bool operator>=(const AdjacencyIterator& it) const
+	{
+		return cur_ >= it.cur_;
+	}
+
+private:
+	_It cur_; ///< current position in the link list
+};
+
+}
+
+#endif /* ADJACENCY_H_ */
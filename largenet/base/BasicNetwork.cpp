@@ -18,22 +18,22 @@ namespace lnet
 {
 
 BasicNetwork::BasicNetwork() :
-	lsCalc_(new DefaultLinkStateCalculator(1)), lscOwn_(true)
+	lsCalc_(0), lscOwn_(false), batchDepth_(0)
 {
 }
 
 BasicNetwork::BasicNetwork(LinkStateCalculator* lsCalc) :
-	lsCalc_(lsCalc), lscOwn_(false)
+	lsCalc_(lsCalc), lscOwn_(false), batchDepth_(0)
 {
 }
 
 BasicNetwork::BasicNetwork(const BasicNetwork& net) :
-	lsCalc_(0), lscOwn_(false)
+	lsCalc_(0), lscOwn_(false), batchDepth_(0)
 {
 	if (net.lscOwn_)
 	{
 		// make our own default link state calculator
-		lsCalc_ = new DefaultLinkStateCalculator(net.numberOfNodeStates());
+		lsCalc_ = net.newDefaultLinkStateCalculator(net.numberOfNodeStates());
 		lscOwn_ = true;
 	}
 	else
@@ -52,41 +52,59 @@ BasicNetwork::~BasicNetwork()
 void BasicNetwork::reset(const id_size_t nNodes, const id_size_t nLinks,
 		const node_state_size_t nNodeStates, LinkStateCalculator* lsCalc)
 {
-	if (lscOwn_)
-		delete lsCalc_;
-	if (lsCalc == 0)
+	const bool own = (lsCalc == 0);
+	if (own)
+		lsCalc = newDefaultLinkStateCalculator(nNodeStates);
+	if (!getLinkStateCalculatorSupported(*lsCalc))
 	{
-		lsCalc_ = new DefaultLinkStateCalculator(nNodeStates);
-		lscOwn_ = true;
+		if (own)
+			delete lsCalc;
+		throw(std::invalid_argument(
+				"LinkStateCalculator is not of the type the network requires!"));
 	}
-	else
-		lsCalc_ = lsCalc;
+	if (lscOwn_)
+		delete lsCalc_;
+	lsCalc_ = lsCalc;
+	lscOwn_ = own;
+	batchNodes_.clear();
 	doReset(nNodes, nLinks, nNodeStates);
 }
 
 void BasicNetwork::setLinkStateCalculator(LinkStateCalculator* lsCalc)
 {
-	if (lscOwn_)
-	{
-		delete lsCalc_;
-		lscOwn_ = false;
-	}
-	if (lsCalc != 0)
+	// check the new calculator before giving up the old one
+	const bool own = (lsCalc == 0);
+	if (own)
+		lsCalc = newDefaultLinkStateCalculator(numberOfNodeStates());
+	const char* error = 0;
+	if (!getLinkStateCalculatorSupported(*lsCalc))
+		error = "LinkStateCalculator is not of the type the network requires!";
+	else if (!own && !isValidLinkStateCalculator(lsCalc))
+		error = "LinkStateCalculator gives impossible link states!";
+	if (error != 0)
 	{
-		if (isValidLinkStateCalculator(lsCalc))
-			lsCalc_ = lsCalc;
-		else
-			throw(std::invalid_argument(
-					"LinkStateCalculator gives impossible link states!"));
-	}
-	else
-	{
-		lsCalc_ = new DefaultLinkStateCalculator(numberOfNodeStates());
-		lscOwn_ = true;
+		if (own)
+			delete lsCalc;
+		throw(std::invalid_argument(error));
 	}
+	if (lscOwn_)
+		delete lsCalc_;
+	lsCalc_ = lsCalc;
+	lscOwn_ = own;
 	recalcLinkStates();
 }
 
+void BasicNetwork::flushBatch()
+{
+	if (batchNodes_.empty())
+		return;
+	std::sort(batchNodes_.begin(), batchNodes_.end());
+	batchNodes_.erase(std::unique(batchNodes_.begin(), batchNodes_.end()),
+			batchNodes_.end());
+	onNodeStatesChange(batchNodes_);
+	batchNodes_.clear();
+}
+
 bool BasicNetwork::isValidLinkStateCalculator(LinkStateCalculator* lc) const
 {
 	bool retval = true;
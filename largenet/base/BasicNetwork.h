@@ -19,6 +19,9 @@
 #include <largenet/base/repo/iterators.h>
 #include <utility>
 #include <string>
+#include <vector>
+#include <algorithm>
+#include <cassert>
 
 namespace lnet
 {
@@ -38,7 +41,12 @@ public:
 	typedef repo::CategoryIterator LinkStateIterator; ///< %Link ID in state iterator type.
 	typedef repo::IndexIteratorRange LinkIteratorRange; ///< %Link ID iterator range type.
 	typedef repo::CategoryIteratorRange LinkStateIteratorRange; ///< %Link ID in state iterator range type.
+	typedef repo::IDSpan IDSpan; ///< Contiguous read-only range of node or link IDs.
 
+	/**
+	 * Default constructor. Leaves the link state calculator unset; derived
+	 * classes install their default through setLinkStateCalculator(0).
+	 */
 	BasicNetwork();
 	BasicNetwork(LinkStateCalculator* lsCalc);
 	BasicNetwork(const BasicNetwork& net);
@@ -68,6 +76,38 @@ public:
 	 * @return Number of links in state @p s.
 	 */
 	id_size_t numberOfLinks(link_state_t s) const;
+	/**
+	 * Register a group of node states. The number of nodes in any of these
+	 * states is then kept up to date, so that numberOfNodes(state_group_t)
+	 * and randomNode(state_group_t) do not need to sum over the states.
+	 * Groups are discarded by reset(), and hence also by reading a network
+	 * with io::EdgelistIn or NetworkBuilder, so register them afterwards.
+	 * @param states %Node states in the group, each at most once.
+	 * @return Handle of the new group.
+	 */
+	state_group_t addNodeStateGroup(const std::vector<node_state_t>& states);
+	/**
+	 * Register a group of link states. See addNodeStateGroup().
+	 * @param states %Link states in the group, each at most once.
+	 * @return Handle of the new group.
+	 */
+	state_group_t addLinkStateGroup(const std::vector<link_state_t>& states);
+	/**
+	 * Return the number of nodes in any state of group @p g. This takes
+	 * constant time.
+	 * @param g %Node state group, as returned by addNodeStateGroup().
+	 * @return Number of nodes in group @p g.
+	 * @throw std::out_of_range if @p g has been discarded by reset().
+	 */
+	id_size_t numberOfNodes(state_group_t g) const;
+	/**
+	 * Return the number of links in any state of group @p g. This takes
+	 * constant time.
+	 * @param g %Link state group, as returned by addLinkStateGroup().
+	 * @return Number of links in group @p g.
+	 * @throw std::out_of_range if @p g has been discarded by reset().
+	 */
+	id_size_t numberOfLinks(state_group_t g) const;
 	/**
 	 * Get number of possible node states.
 	 * @return Number of possible node states.
@@ -82,7 +122,12 @@ public:
 	/**
 	 * Set the LinkStateCalculator object to use in order to keep node and link
 	 * states consistent.
-	 * @param lsCalc pointer to LinkStateCalculator object
+	 * @param lsCalc pointer to LinkStateCalculator object, or 0 to use a
+	 * DefaultLinkStateCalculator (or a default-constructed calculator of the
+	 * type the network requires, see TypedNetwork).
+	 * @throw std::invalid_argument if @p lsCalc gives impossible link states
+	 * or is not of the type the network requires (see TypedNetwork). The
+	 * network keeps its current calculator in this case.
 	 */
 	void setLinkStateCalculator(LinkStateCalculator* lsCalc);
 
@@ -115,6 +160,14 @@ public:
 	 * @return Unique ID of link created
 	 */
 	link_id_t addLink(node_id_t source, node_id_t target);
+	/**
+	 * Add links between the node pairs in @p edges, in the given order. This
+	 * is equivalent to calling addLink() for each pair, but inserts all links
+	 * into the link store at once and does not call onAddLink() for them, so
+	 * it is much faster for large numbers of links. See also NetworkBuilder.
+	 * @param edges (source, target) pairs of existing node IDs.
+	 */
+	void addLinks(const EdgeList& edges);
 
 	/**
 	 * Change link to connect the new @p source with the new @p target.
@@ -150,6 +203,14 @@ public:
 	 */
 	void clear();
 
+	/**
+	 * Renumber nodes, links (and triples, if any) with consecutive IDs starting
+	 * at zero, keeping their order and states. All references between them
+	 * are updated. This speeds up iteration after many removals.
+	 * @return Maps from old to new IDs.
+	 */
+	IDMap compact();
+
 	/**
 	 * Check if there exists a direct link between two nodes.
 	 * @param source ID of source node.
@@ -159,6 +220,46 @@ public:
 	 */
 	std::pair<bool, link_id_t> isLink(node_id_t source, node_id_t target) const;
 
+	/**
+	 * Enable or disable a hash index of links by their end nodes. With the
+	 * index, isLink() takes constant expected time instead of time linear in
+	 * the smaller degree of the two nodes, at the expense of extra memory and
+	 * a hash table update on each link change. The index is off by default.
+	 * @param enable True to build and maintain the index, false to drop it.
+	 */
+	void enableEdgeIndex(bool enable = true);
+	/**
+	 * Return true if the network maintains an edge index (see enableEdgeIndex()).
+	 */
+	bool hasEdgeIndex() const;
+
+	/**
+	 * Return number of neighbors of node @p n in state @p s. Neighbors are
+	 * counted as often as they appear in neighbors(@p n). This takes constant
+	 * time if neighbor state counts are enabled (see
+	 * enableNeighborStateCounts()) or for networks of PartitionedNode objects,
+	 * and time linear in the degree of @p n otherwise.
+	 * @param n %Node ID
+	 * @param s %Node state
+	 * @return Number of neighbors in state @p s.
+	 */
+	id_size_t neighborsInState(node_id_t n, node_state_t s) const;
+	/**
+	 * Enable or disable per-node counts of neighbors in each node state. With
+	 * the counts, neighborsInState() takes constant time. They take one
+	 * counter per node and node state, and a state change of node @p n costs
+	 * time linear in its degree to update its neighbors' counts. The counts
+	 * are off by default.
+	 * @param enable True to set up and maintain the counts, false to drop
+	 * them.
+	 */
+	void enableNeighborStateCounts(bool enable = true);
+	/**
+	 * Return true if the network maintains neighbor state counts (see
+	 * enableNeighborStateCounts()).
+	 */
+	bool hasNeighborStateCounts() const;
+
 	/**
 	 * Degree of node @p n.
 	 * @param n ID of node.
@@ -172,6 +273,36 @@ public:
 	 *	@param s New state of the node.
 	 */
 	void setNodeState(node_id_t n, node_state_t s);
+	/**
+	 * Put node @c it->first in state @c it->second for each @c it in
+	 * [@p first, @p last), e.g. a range of std::pair<node_id_t, node_state_t>.
+	 * The states of the affected links (and triples, if any) are recalculated
+	 * once at the end, each link only once, as for a beginBatch() /
+	 * commitBatch() scope.
+	 * @param first Input iterator to first (node, state) pair.
+	 * @param last Past-the-end iterator.
+	 */
+	template<class InputIterator>
+	void setNodeStates(InputIterator first, InputIterator last);
+	/**
+	 * Start deferring link (and triple) state updates after node state
+	 * changes. Node states, node state counts and neighbor state information
+	 * are updated immediately, but link and triple states are stale until the
+	 * matching commitBatch(). Adding, changing and removing links is fine
+	 * within a batch. Batches may be nested; only the outermost
+	 * commitBatch() recalculates.
+	 */
+	void beginBatch();
+	/**
+	 * End a batch started with beginBatch(). Recalculates the states of all
+	 * links (and triples) adjacent to nodes whose state changed, each one
+	 * once, using the bulk repository path.
+	 */
+	void commitBatch();
+	/**
+	 * Return true if inside a beginBatch() / commitBatch() scope.
+	 */
+	bool inBatch() const;
 
 	/**
 	 * Return state of node with ID @p n.
@@ -213,6 +344,22 @@ public:
 	 * in this state.
 	 */
 	LinkStateIteratorRange links(link_state_t s) const;
+	/**
+	 * Return the IDs of all nodes in state @p s as a contiguous array,
+	 * without copying. This contains the same IDs in the same order as
+	 * nodes(node_state_t), but can e.g. be split among threads. It is
+	 * invalidated by any change to the network.
+	 * @param s %Node state.
+	 * @return Pointers to the first and past the last node ID in state @p s.
+	 */
+	IDSpan nodeIDs(node_state_t s) const;
+	/**
+	 * Return the IDs of all links in state @p s as a contiguous array,
+	 * without copying. See nodeIDs().
+	 * @param s %Link state.
+	 * @return Pointers to the first and past the last link ID in state @p s.
+	 */
+	IDSpan linkIDs(link_state_t s) const;
 
 	/**
 	 * Get random node.
@@ -240,6 +387,96 @@ public:
 	 * @p s and the returned link ID is invalid.
 	 */
 	std::pair<bool, link_id_t> randomLink(link_state_t s) const;
+	/**
+	 * Get random node in any state of group @p g, chosen uniformly among all
+	 * these nodes.
+	 * @param g %Node state group, as returned by addNodeStateGroup().
+	 * @return Pair of bool and node ID. If @p first is false, there are no nodes
+	 * in group @p g and the returned node ID is invalid.
+	 */
+	std::pair<bool, node_id_t> randomNode(state_group_t g) const;
+	/**
+	 * Get random link in any state of group @p g, chosen uniformly among all
+	 * these links.
+	 * @param g %Link state group, as returned by addLinkStateGroup().
+	 * @return Pair of bool and link ID. If @p first is false, there are no links
+	 * in group @p g and the returned link ID is invalid.
+	 */
+	std::pair<bool, link_id_t> randomLink(state_group_t g) const;
+
+	/**
+	 * Set weight of node @p n, e.g. its individual activity. Nodes keep their
+	 * weight when changing state; new nodes have weight 1.
+	 * @param n %Node ID.
+	 * @param w Non-negative weight.
+	 */
+	void setNodeWeight(node_id_t n, double w);
+	/**
+	 * Return weight of node @p n.
+	 * @param n %Node ID.
+	 * @return %Node weight, 1 if no weights have been set.
+	 */
+	double nodeWeight(node_id_t n) const;
+	/**
+	 * Set weight of link @p l. Links keep their weight when changing state;
+	 * new links have weight 1.
+	 * @param l %Link ID.
+	 * @param w Non-negative weight.
+	 */
+	void setLinkWeight(link_id_t l, double w);
+	/**
+	 * Return weight of link @p l.
+	 * @param l %Link ID.
+	 * @return %Link weight, 1 if no weights have been set.
+	 */
+	double linkWeight(link_id_t l) const;
+	/**
+	 * Return total weight of all nodes in state @p s.
+	 * @param s %Node state.
+	 * @return Sum of node weights.
+	 */
+	double totalNodeWeight(node_state_t s) const;
+	/**
+	 * Return total weight of all links in state @p s.
+	 * @param s %Link state.
+	 * @return Sum of link weights.
+	 */
+	double totalLinkWeight(link_state_t s) const;
+	/**
+	 * Get random node in state @p s, chosen with probability proportional to
+	 * its weight. This takes time logarithmic in the number of nodes in
+	 * state @p s.
+	 * @param s %Node state to choose from.
+	 * @return Pair of bool and node ID. If @p first is false, the nodes in
+	 * state @p s have zero total weight and the returned node ID is invalid.
+	 */
+	std::pair<bool, node_id_t> randomNodeWeighted(node_state_t s) const;
+	/**
+	 * Get random link in state @p s, chosen with probability proportional to
+	 * its weight. See randomNodeWeighted().
+	 * @param s %Link state to choose from.
+	 * @return Pair of bool and link ID. If @p first is false, the links in
+	 * state @p s have zero total weight and the returned link ID is invalid.
+	 */
+	std::pair<bool, link_id_t> randomLinkWeighted(link_state_t s) const;
+	/**
+	 * Get random node, chosen with probability proportional to its degree.
+	 * Self-loops count twice. This takes constant time.
+	 * @return Pair of bool and node ID. If @p first is false, the network has
+	 * no links and the returned node ID is invalid.
+	 */
+	std::pair<bool, node_id_t> randomNodeByDegree() const;
+	/**
+	 * Get random node in state @p s, chosen with probability proportional to
+	 * its degree. This takes constant time, but the first call sets up a
+	 * table of link ends by node state, which takes time linear in the number
+	 * of links. From then on, the table is kept up to date by all network
+	 * changes, at constant cost per link end.
+	 * @param s %Node state to choose from.
+	 * @return Pair of bool and node ID. If @p first is false, the nodes in
+	 * state @p s have no links and the returned node ID is invalid.
+	 */
+	std::pair<bool, node_id_t> randomNodeByDegree(node_state_t s) const;
 
 	/**
 	 * Get random link adjacent to node @p n.
@@ -255,6 +492,28 @@ public:
 	 * the returned node ID is invalid.
 	 */
 	std::pair<bool, node_id_t> randomNeighbor(node_id_t n) const;
+	/**
+	 * Get random link in state @p s adjacent to node @p n. This takes time
+	 * linear in the number of node states for networks of PartitionedNode
+	 * objects, and time linear in the degree of @p n otherwise.
+	 * @param n %Node ID
+	 * @param s %Link state to choose from.
+	 * @return Pair of bool and link ID. If @p first is false, node @p n has no
+	 * links in state @p s and the returned link ID is invalid.
+	 */
+	std::pair<bool, link_id_t> randomNeighborLink(node_id_t n,
+			link_state_t s) const;
+	/**
+	 * Get random neighbor of node @p n in state @p s. Neighbors are chosen as
+	 * often as they appear in neighbors(@p n). This takes constant time for
+	 * networks of PartitionedNode objects, and time linear in the degree of
+	 * @p n otherwise.
+	 * @param n %Node ID
+	 * @param s %Node state to choose from.
+	 * @return Pair of bool and node ID. If @p first is false, node @p n has no
+	 * neighbors in state @p s and the returned node ID is invalid.
+	 */
+	std::pair<bool, node_id_t> randomNeighbor(node_id_t n, node_state_t s) const;
 
 	//	/**
 	//	 * Return iterator range of all neighboring nodes of node @p n.
@@ -287,12 +546,14 @@ protected:
 	virtual node_id_t doAddNode() = 0;
 	virtual node_id_t doAddNode(node_state_t s) = 0;
 	virtual link_id_t doAddLink(node_id_t source, node_id_t target) = 0;
+	virtual void doAddLinks(const EdgeList& edges) = 0;
 	virtual bool
 			doChangeLink(link_id_t l, node_id_t source, node_id_t target) = 0;
 	virtual void doRemoveLink(link_id_t l) = 0;
 	virtual void doRemoveNode(node_id_t n) = 0;
 	virtual void doRemoveAllLinks() = 0;
 	virtual void doClear() = 0;
+	virtual void doCompact(IDMap& map) = 0;
 	virtual void doSetNodeState(node_id_t n, node_state_t s) = 0;
 
 	virtual void beforeRemoveLink(link_id_t l) = 0;
@@ -304,6 +565,13 @@ protected:
 	virtual void onAddLink(link_id_t l) = 0;
 	virtual void onChangeLink(link_id_t l, node_id_t old_source, node_id_t old_target, bool success) = 0;
 	virtual void onNodeStateChange(node_id_t n) = 0;
+	/**
+	 * Recalculate dependent states after a batch of node state changes (see
+	 * commitBatch()).
+	 * @param nodes IDs of nodes whose state changed, ascending and unique.
+	 * Nodes removed during the batch may be among them.
+	 */
+	virtual void onNodeStatesChange(const std::vector<node_id_t>& nodes) = 0;
 
 	virtual void recalcLinkStates() = 0;
 
@@ -324,6 +592,12 @@ private:
 	virtual id_size_t getNumberOfNodes(node_state_t s) const = 0;
 	virtual id_size_t getNumberOfLinks() const = 0;
 	virtual id_size_t getNumberOfLinks(node_state_t s) const = 0;
+	virtual id_size_t getNumberOfNodes(state_group_t g) const = 0;
+	virtual id_size_t getNumberOfLinks(state_group_t g) const = 0;
+	virtual state_group_t doAddNodeStateGroup(
+			const std::vector<node_state_t>& states) = 0;
+	virtual state_group_t doAddLinkStateGroup(
+			const std::vector<link_state_t>& states) = 0;
 	virtual node_state_size_t getNumberOfNodeStates() const = 0;
 	virtual link_state_size_t getNumberOfLinkStates() const = 0;
 
@@ -335,23 +609,66 @@ private:
 
 	virtual std::pair<bool, link_id_t> doIsLink(node_id_t source,
 			node_id_t target) const = 0;
+	virtual void doEnableEdgeIndex(bool enable) = 0;
+	virtual bool getEdgeIndexEnabled() const = 0;
+	virtual id_size_t getNeighborsInState(node_id_t n, node_state_t s) const = 0;
+	virtual void doEnableNeighborStateCounts(bool enable) = 0;
+	virtual bool getNeighborStateCountsEnabled() const = 0;
+	/**
+	 * Return true if the network can work with link state calculator
+	 * @p lc (see TypedNetwork).
+	 */
+	virtual bool getLinkStateCalculatorSupported(
+			const LinkStateCalculator& lc) const = 0;
+	/**
+	 * Create the link state calculator used if none is given, for
+	 * @p nNodeStates node states. It must be supported by the network.
+	 */
+	virtual LinkStateCalculator* newDefaultLinkStateCalculator(
+			node_state_size_t nNodeStates) const = 0;
 
 	virtual std::pair<bool, node_id_t> getRandomNode() const = 0;
 	virtual std::pair<bool, node_id_t> getRandomNode(node_state_t s) const = 0;
 	virtual std::pair<bool, link_id_t> getRandomLink() const = 0;
 	virtual std::pair<bool, link_id_t> getRandomLink(link_state_t s) const = 0;
+	virtual std::pair<bool, node_id_t> getRandomNode(state_group_t g) const = 0;
+	virtual std::pair<bool, link_id_t> getRandomLink(state_group_t g) const = 0;
+	virtual std::pair<bool, node_id_t> getRandomNodeWeighted(node_state_t s) const = 0;
+	virtual std::pair<bool, link_id_t> getRandomLinkWeighted(link_state_t s) const = 0;
+	virtual std::pair<bool, node_id_t> getRandomNodeByDegree() const = 0;
+	virtual std::pair<bool, node_id_t> getRandomNodeByDegree(node_state_t s) const = 0;
+
+	virtual void doSetNodeWeight(node_id_t n, double w) = 0;
+	virtual double getNodeWeight(node_id_t n) const = 0;
+	virtual void doSetLinkWeight(link_id_t l, double w) = 0;
+	virtual double getLinkWeight(link_id_t l) const = 0;
+	virtual double getTotalNodeWeight(node_state_t s) const = 0;
+	virtual double getTotalLinkWeight(link_state_t s) const = 0;
 	virtual std::pair<bool, link_id_t>
 			getRandomNeighborLink(node_id_t n) const = 0;
 	virtual std::pair<bool, node_id_t> getRandomNeighbor(node_id_t n) const = 0;
+	virtual std::pair<bool, link_id_t> getRandomNeighborLink(node_id_t n,
+			link_state_t s) const = 0;
+	virtual std::pair<bool, node_id_t> getRandomNeighbor(node_id_t n,
+			node_state_t s) const = 0;
 
 	virtual LinkIteratorRange getLinks() const = 0;
 	virtual LinkStateIteratorRange getLinks(link_state_t s) const = 0;
 	virtual NodeIteratorRange getNodes() const = 0;
 	virtual NodeStateIteratorRange getNodes(link_state_t s) const = 0;
+	virtual IDSpan getNodeIDs(node_state_t s) const = 0;
+	virtual IDSpan getLinkIDs(link_state_t s) const = 0;
 
 private:
+	/**
+	 * Recalculate states for the node state changes of the current batch.
+	 */
+	void flushBatch();
+
 	LinkStateCalculator* lsCalc_; ///< link state calculator @todo Use shared_ptr?
 	bool lscOwn_; ///< true if we need to manage the link state calculator
+	unsigned int batchDepth_; ///< nesting depth of beginBatch() calls
+	std::vector<node_id_t> batchNodes_; ///< nodes whose state changed in the current batch
 };
 
 inline node_id_t BasicNetwork::addNode()
@@ -376,6 +693,11 @@ inline link_id_t BasicNetwork::addLink(const node_id_t source,
 	return id;
 }
 
+inline void BasicNetwork::addLinks(const EdgeList& edges)
+{
+	doAddLinks(edges);
+}
+
 inline bool BasicNetwork::changeLink(const link_id_t l, const node_id_t source,
 		const node_id_t target)
 {
@@ -407,6 +729,32 @@ inline std::pair<bool, link_id_t> BasicNetwork::isLink(const node_id_t source,
 	return doIsLink(source, target);
 }
 
+inline void BasicNetwork::enableEdgeIndex(const bool enable)
+{
+	doEnableEdgeIndex(enable);
+}
+
+inline bool BasicNetwork::hasEdgeIndex() const
+{
+	return getEdgeIndexEnabled();
+}
+
+inline id_size_t BasicNetwork::neighborsInState(const node_id_t n,
+		const node_state_t s) const
+{
+	return getNeighborsInState(n, s);
+}
+
+inline void BasicNetwork::enableNeighborStateCounts(const bool enable)
+{
+	doEnableNeighborStateCounts(enable);
+}
+
+inline bool BasicNetwork::hasNeighborStateCounts() const
+{
+	return getNeighborStateCountsEnabled();
+}
+
 inline link_state_t BasicNetwork::linkState(const link_id_t l) const
 {
 	return getLinkState(l);
@@ -427,6 +775,28 @@ inline id_size_t BasicNetwork::numberOfLinks(const link_state_t s) const
 	return getNumberOfLinks(s);
 }
 
+inline state_group_t BasicNetwork::addNodeStateGroup(
+		const std::vector<node_state_t>& states)
+{
+	return doAddNodeStateGroup(states);
+}
+
+inline state_group_t BasicNetwork::addLinkStateGroup(
+		const std::vector<link_state_t>& states)
+{
+	return doAddLinkStateGroup(states);
+}
+
+inline id_size_t BasicNetwork::numberOfNodes(const state_group_t g) const
+{
+	return getNumberOfNodes(g);
+}
+
+inline id_size_t BasicNetwork::numberOfLinks(const state_group_t g) const
+{
+	return getNumberOfLinks(g);
+}
+
 inline id_size_t BasicNetwork::numberOfNodes() const
 {
 	return getNumberOfNodes();
@@ -457,6 +827,71 @@ inline std::pair<bool, link_id_t> BasicNetwork::randomLink(const link_state_t s)
 	return getRandomLink(s);
 }
 
+inline std::pair<bool, node_id_t> BasicNetwork::randomNode(
+		const state_group_t g) const
+{
+	return getRandomNode(g);
+}
+
+inline std::pair<bool, link_id_t> BasicNetwork::randomLink(
+		const state_group_t g) const
+{
+	return getRandomLink(g);
+}
+
+inline void BasicNetwork::setNodeWeight(const node_id_t n, const double w)
+{
+	doSetNodeWeight(n, w);
+}
+
+inline double BasicNetwork::nodeWeight(const node_id_t n) const
+{
+	return getNodeWeight(n);
+}
+
+inline void BasicNetwork::setLinkWeight(const link_id_t l, const double w)
+{
+	doSetLinkWeight(l, w);
+}
+
+inline double BasicNetwork::linkWeight(const link_id_t l) const
+{
+	return getLinkWeight(l);
+}
+
+inline double BasicNetwork::totalNodeWeight(const node_state_t s) const
+{
+	return getTotalNodeWeight(s);
+}
+
+inline double BasicNetwork::totalLinkWeight(const link_state_t s) const
+{
+	return getTotalLinkWeight(s);
+}
+
+inline std::pair<bool, node_id_t> BasicNetwork::randomNodeWeighted(
+		const node_state_t s) const
+{
+	return getRandomNodeWeighted(s);
+}
+
+inline std::pair<bool, link_id_t> BasicNetwork::randomLinkWeighted(
+		const link_state_t s) const
+{
+	return getRandomLinkWeighted(s);
+}
+
+inline std::pair<bool, node_id_t> BasicNetwork::randomNodeByDegree() const
+{
+	return getRandomNodeByDegree();
+}
+
+inline std::pair<bool, node_id_t> BasicNetwork::randomNodeByDegree(
+		const node_state_t s) const
+{
+	return getRandomNodeByDegree(s);
+}
+
 inline std::pair<bool, link_id_t> BasicNetwork::randomNeighborLink(
 		const node_id_t n) const
 {
@@ -469,6 +904,18 @@ inline std::pair<bool, node_id_t> BasicNetwork::randomNeighbor(
 	return getRandomNeighbor(n);
 }
 
+inline std::pair<bool, link_id_t> BasicNetwork::randomNeighborLink(
+		const node_id_t n, const link_state_t s) const
+{
+	return getRandomNeighborLink(n, s);
+}
+
+inline std::pair<bool, node_id_t> BasicNetwork::randomNeighbor(
+		const node_id_t n, const node_state_t s) const
+{
+	return getRandomNeighbor(n, s);
+}
+
 inline std::pair<bool, node_id_t> BasicNetwork::randomNode() const
 {
 	return getRandomNode();
@@ -501,14 +948,57 @@ inline void BasicNetwork::clear()
 {
 	beforeClear();
 	doClear();
+	batchNodes_.clear();
+}
+
+inline IDMap BasicNetwork::compact()
+{
+	IDMap map;
+	// pending node IDs would not survive renumbering
+	flushBatch();
+	doCompact(map);
+	return map;
 }
 
 inline void BasicNetwork::setNodeState(const node_id_t n, const node_state_t s)
 {
+	if (batchDepth_ > 0)
+	{
+		if (nodeState(n) != s)
+			batchNodes_.push_back(n);
+		doSetNodeState(n, s);
+		return;
+	}
 	doSetNodeState(n, s);
 	onNodeStateChange(n);
 }
 
+template<class InputIterator>
+void BasicNetwork::setNodeStates(InputIterator first, const InputIterator last)
+{
+	beginBatch();
+	for (; first != last; ++first)
+		setNodeState(first->first, first->second);
+	commitBatch();
+}
+
+inline void BasicNetwork::beginBatch()
+{
+	++batchDepth_;
+}
+
+inline void BasicNetwork::commitBatch()
+{
+	assert(batchDepth_ > 0);
+	if (--batchDepth_ == 0)
+		flushBatch();
+}
+
+inline bool BasicNetwork::inBatch() const
+{
+	return batchDepth_ > 0;
+}
+
 inline node_id_t BasicNetwork::source(const link_id_t l) const
 {
 	return getSource(l);
@@ -540,6 +1030,16 @@ inline BasicNetwork::LinkIteratorRange BasicNetwork::links() const
 {
 	return getLinks();
 }
+
+inline BasicNetwork::IDSpan BasicNetwork::nodeIDs(const node_state_t s) const
+{
+	return getNodeIDs(s);
+}
+
+inline BasicNetwork::IDSpan BasicNetwork::linkIDs(const link_state_t s) const
+{
+	return getLinkIDs(s);
+}
 }
 
 #endif /* BASICNETWORK_H_ */
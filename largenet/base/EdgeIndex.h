@@ -0,0 +1,255 @@
+/**
+ * This work is licensed under the Creative Commons
+ * Attribution-NonCommercial 3.0 Unported License. To view a copy of this
+ * license, visit http://creativecommons.org/licenses/by-nc/3.0/ or send a
+ * letter to Creative Commons, 444 Castro Street, Suite 900, Mountain View,
+ * California, 94041, USA.
+ */
+/**
+ * @file EdgeIndex.h
+ * Declaration of the lnet::EdgeIndex class.
+ */
+#ifndef EDGEINDEX_H_
+#define EDGEINDEX_H_
+
+#include <largenet/base/types.h>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cassert>
+
+namespace lnet
+{
+
+/**
+ * Hash index of the links of a network by their (unordered) end node pair.
+ *
+ * For every pair of connected nodes, the index stores one of the connecting
+ * links and the number of parallel links. Lookups take constant expected
+ * time. The table uses open addressing with linear probing and is kept at
+ * most half full, so it needs between 64 and 128 bytes per connected node
+ * pair on 64-bit systems.
+ */
+class EdgeIndex
+{
+public:
+	/**
+	 * Constructor. Creates an empty index.
+	 */
+	EdgeIndex();
+
+	/**
+	 * Look up a link between nodes @p a and @p b.
+	 * @param a %Node ID
+	 * @param b %Node ID
+	 * @return Pair of bool and link ID. If @p first is false, there is no such
+	 * link and the returned link ID is invalid.
+	 */
+	std::pair<bool, link_id_t> find(node_id_t a, node_id_t b) const;
+	/**
+	 * Register link @p l between nodes @p a and @p b.
+	 * @param a %Node ID
+	 * @param b %Node ID
+	 * @param l %Link ID
+	 */
+	void insert(node_id_t a, node_id_t b, link_id_t l);
+	/**
+	 * Unregister link @p l between nodes @p a and @p b.
+	 * @param a %Node ID
+	 * @param b %Node ID
+	 * @param l %Link ID
+	 * @return True if other links between @p a and @p b remain and @p l was
+	 * the one stored; in this case, call setLink() with one of them.
+	 */
+	bool erase(node_id_t a, node_id_t b, link_id_t l);
+	/**
+	 * Replace the link stored for nodes @p a and @p b.
+	 * @param a %Node ID
+	 * @param b %Node ID
+	 * @param l %Link ID
+	 */
+	void setLink(node_id_t a, node_id_t b, link_id_t l);
+
+	/**
+	 * Remove all entries.
+	 */
+	void clear();
+	/**
+	 * Make room for @p n node pairs without rehashing.
+	 * @param n Number of node pairs.
+	 */
+	void reserve(id_size_t n);
+	/**
+	 * Return number of connected node pairs.
+	 */
+	id_size_t size() const;
+	/**
+	 * Return memory used by the table in bytes.
+	 */
+	id_size_t memoryUsage() const;
+
+private:
+	struct Entry
+	{
+		node_id_t a, b; ///< end nodes, a <= b
+		link_id_t link; ///< one of the links connecting a and b
+		id_size_t count; ///< number of links connecting a and b, 0 if slot is empty
+	};
+	typedef std::vector<Entry> EntryVector;
+	static const id_size_t npos = static_cast<id_size_t>(-1);
+
+	id_size_t home(node_id_t a, node_id_t b) const;
+	id_size_t slot(node_id_t a, node_id_t b) const;
+	void rehash(id_size_t capacity);
+
+	EntryVector table_; ///< hash table, size is zero or a power of two
+	id_size_t size_; ///< number of used slots
+};
+
+inline EdgeIndex::EdgeIndex() :
+	size_(0)
+{
+}
+
+inline id_size_t EdgeIndex::home(const node_id_t a, const node_id_t b) const
+{
+	id_size_t h = a * 2654435761UL + b;
+	h ^= h >> 16;
+	h *= 0x85ebca6bUL;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35UL;
+	h ^= h >> 16;
+	return h & (table_.size() - 1);
+}
+
+inline id_size_t EdgeIndex::slot(node_id_t a, node_id_t b) const
+{
+	if (size_ == 0)
+		return npos;
+	if (a > b)
+		std::swap(a, b);
+	const id_size_t mask = table_.size() - 1;
+	for (id_size_t i = home(a, b);; i = (i + 1) & mask)
+	{
+		const Entry& e = table_[i];
+		if (e.count == 0)
+			return npos;
+		if ((e.a == a) && (e.b == b))
+			return i;
+	}
+}
+
+inline std::pair<bool, link_id_t> EdgeIndex::find(const node_id_t a,
+		const node_id_t b) const
+{
+	const id_size_t i = slot(a, b);
+	if (i == npos)
+		return std::make_pair(false, 0);
+	return std::make_pair(true, table_[i].link);
+}
+
+inline void EdgeIndex::insert(node_id_t a, node_id_t b, const link_id_t l)
+{
+	if (a > b)
+		std::swap(a, b);
+	if (2 * (size_ + 1) > table_.size())
+		rehash(std::max<id_size_t>(16, 2 * table_.size()));
+	const id_size_t mask = table_.size() - 1;
+	id_size_t i = home(a, b);
+	for (; table_[i].count != 0; i = (i + 1) & mask)
+	{
+		if ((table_[i].a == a) && (table_[i].b == b))
+		{
+			++table_[i].count;
+			return;
+		}
+	}
+	Entry& e = table_[i];
+	e.a = a;
+	e.b = b;
+	e.link = l;
+	e.count = 1;
+	++size_;
+}
+
+inline bool EdgeIndex::erase(const node_id_t a, const node_id_t b,
+		const link_id_t l)
+{
+	id_size_t i = slot(a, b);
+	assert(i != npos);
+	if (i == npos)
+		return false;
+	if (--table_[i].count > 0)
+		return table_[i].link == l;
+
+	// backward shift deletion keeps probe sequences intact
+	--size_;
+	const id_size_t mask = table_.size() - 1;
+	for (id_size_t j = (i + 1) & mask; table_[j].count != 0; j = (j + 1) & mask)
+	{
+		const id_size_t k = home(table_[j].a, table_[j].b);
+		const bool stays = (i <= j) ? ((i < k) && (k <= j)) : ((i < k) || (k
+				<= j));
+		if (!stays)
+		{
+			table_[i] = table_[j];
+			table_[j].count = 0;
+			i = j;
+		}
+	}
+	return false;
+}
+
+inline void EdgeIndex::setLink(const node_id_t a, const node_id_t b,
+		const link_id_t l)
+{
+	const id_size_t i = slot(a, b);
+	assert(i != npos);
+	if (i != npos)
+		table_[i].link = l;
+}
+
+inline void EdgeIndex::clear()
+{
+	EntryVector().swap(table_);
+	size_ = 0;
+}
+
+inline void EdgeIndex::reserve(const id_size_t n)
+{
+	id_size_t capacity = 16;
+	while (capacity < 2 * n)
+		capacity *= 2;
+	if (capacity > table_.size())
+		rehash(capacity);
+}
+
+inline id_size_t EdgeIndex::size() const
+{
+	return size_;
+}
+
+inline id_size_t EdgeIndex::memoryUsage() const
+{
+	return table_.capacity() * sizeof(Entry);
+}
+
+inline void EdgeIndex::rehash(const id_size_t capacity)
+{
+	EntryVector old(capacity); // value-initialized, i.e. all slots empty
+	old.swap(table_);
+	const id_size_t mask = capacity - 1;
+	for (EntryVector::const_iterator it = old.begin(); it != old.end(); ++it)
+	{
+		if (it->count == 0)
+			continue;
+		id_size_t j = home(it->a, it->b);
+		while (table_[j].count != 0)
+			j = (j + 1) & mask;
+		table_[j] = *it;
+	}
+}
+
+}
+
+#endif /* EDGEINDEX_H_ */
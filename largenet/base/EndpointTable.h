@@ -0,0 +1,181 @@
+/**
+ * This work is licensed under the Creative Commons
+ * Attribution-NonCommercial 3.0 Unported License. To view a copy of this
+ * license, visit http://creativecommons.org/licenses/by-nc/3.0/ or send a
+ * letter to Creative Commons, 444 Castro Street, Suite 900, Mountain View,
+ * California, 94041, USA.
+ */
+/**
+ * @file EndpointTable.h
+ * Declaration of the lnet::EndpointTable class.
+ */
+#ifndef ENDPOINTTABLE_H_
+#define ENDPOINTTABLE_H_
+
+#include <largenet/base/types.h>
+#include <vector>
+#include <utility>
+#include <cassert>
+
+namespace lnet
+{
+
+/**
+ * Table of link ends (stubs), grouped by the state of the node they belong to.
+ *
+ * Every link contributes two stubs, one at its source and one at its target.
+ * A node of degree @c k thus owns @c k stubs, and a stub drawn uniformly from
+ * the stubs of node state @c s belongs to a node in state @c s with probability
+ * proportional to its degree. Insertion, removal, and moving a stub to another
+ * state take constant time; each stub needs 16 bytes on 64-bit systems.
+ */
+class EndpointTable
+{
+public:
+	typedef std::pair<link_id_t, bool> Stub; ///< link ID and true if the stub is at the link's source
+
+	/**
+	 * Constructor.
+	 * @param nStates Number of node states.
+	 */
+	explicit EndpointTable(node_state_size_t nStates);
+
+	/**
+	 * Add the stub of link @p l at its source or target.
+	 * @param l %Link ID
+	 * @param atSource True for the source end, false for the target end.
+	 * @param s State of the node the stub belongs to.
+	 */
+	void insert(link_id_t l, bool atSource, node_state_t s);
+	/**
+	 * Remove the stub of link @p l at its source or target.
+	 * @param l %Link ID
+	 * @param atSource True for the source end, false for the target end.
+	 * @param s State of the node the stub belongs to.
+	 */
+	void erase(link_id_t l, bool atSource, node_state_t s);
+	/**
+	 * Move the stub of link @p l at its source or target from node state
+	 * @p from to @p to. Moving a stub that is already in state @p to does
+	 * nothing.
+	 * @param l %Link ID
+	 * @param atSource True for the source end, false for the target end.
+	 * @param from Old state of the node the stub belongs to.
+	 * @param to New state of the node the stub belongs to.
+	 */
+	void move(link_id_t l, bool atSource, node_state_t from, node_state_t to);
+
+	/**
+	 * Return number of stubs of nodes in state @p s, i.e. the sum of their
+	 * degrees.
+	 * @param s %Node state
+	 */
+	id_size_t count(node_state_t s) const;
+	/**
+	 * Return the @p i-th stub of nodes in state @p s.
+	 * @param s %Node state
+	 * @param i Number of stub, less than count(s).
+	 */
+	Stub stub(node_state_t s, id_size_t i) const;
+
+	/**
+	 * Remove all stubs.
+	 */
+	void clear();
+	/**
+	 * Return memory used by the table in bytes.
+	 */
+	id_size_t memoryUsage() const;
+
+private:
+	typedef std::vector<id_size_t> KeyVector;
+
+	static id_size_t key(link_id_t l, bool atSource);
+	bool contains(id_size_t k, node_state_t s) const;
+
+	std::vector<KeyVector> stubs_; ///< stub keys of each node state
+	KeyVector pos_; ///< position of each stub in its state's list, by key
+};
+
+inline EndpointTable::EndpointTable(const node_state_size_t nStates) :
+	stubs_(nStates)
+{
+}
+
+inline id_size_t EndpointTable::key(const link_id_t l, const bool atSource)
+{
+	return 2 * l + (atSource ? 0 : 1);
+}
+
+inline bool EndpointTable::contains(const id_size_t k, const node_state_t s) const
+{
+	return (k < pos_.size()) && (pos_[k] < stubs_[s].size())
+			&& (stubs_[s][pos_[k]] == k);
+}
+
+inline void EndpointTable::insert(const link_id_t l, const bool atSource,
+		const node_state_t s)
+{
+	assert(s < stubs_.size());
+	const id_size_t k = key(l, atSource);
+	if (k >= pos_.size())
+		pos_.resize(2 * (l + 1));
+	pos_[k] = stubs_[s].size();
+	stubs_[s].push_back(k);
+}
+
+inline void EndpointTable::erase(const link_id_t l, const bool atSource,
+		const node_state_t s)
+{
+	const id_size_t k = key(l, atSource);
+	assert(contains(k, s));
+	KeyVector& list = stubs_[s];
+	const id_size_t last = list.back();
+	list[pos_[k]] = last;
+	pos_[last] = pos_[k];
+	list.pop_back();
+}
+
+inline void EndpointTable::move(const link_id_t l, const bool atSource,
+		const node_state_t from, const node_state_t to)
+{
+	if ((from == to) || contains(key(l, atSource), to))
+		return;
+	erase(l, atSource, from);
+	insert(l, atSource, to);
+}
+
+inline id_size_t EndpointTable::count(const node_state_t s) const
+{
+	assert(s < stubs_.size());
+	return stubs_[s].size();
+}
+
+inline EndpointTable::Stub EndpointTable::stub(const node_state_t s,
+		const id_size_t i) const
+{
+	assert(i < count(s));
+	const id_size_t k = stubs_[s][i];
+	return std::make_pair(k / 2, k % 2 == 0);
+}
+
+inline void EndpointTable::clear()
+{
+	for (std::vector<KeyVector>::iterator it = stubs_.begin(); it
+			!= stubs_.end(); ++it)
+		KeyVector().swap(*it);
+	KeyVector().swap(pos_);
+}
+
+inline id_size_t EndpointTable::memoryUsage() const
+{
+	id_size_t bytes = pos_.capacity() * sizeof(id_size_t);
+	for (std::vector<KeyVector>::const_iterator it = stubs_.begin(); it
+			!= stubs_.end(); ++it)
+		bytes += it->capacity() * sizeof(id_size_t);
+	return bytes;
+}
+
+}
+
+#endif /* ENDPOINTTABLE_H_ */
@@ -0,0 +1,84 @@
+/**
+ * This work is licensed under the Creative Commons
+ * Attribution-NonCommercial 3.0 Unported License. To view a copy of this
+ * license, visit http://creativecommons.org/licenses/by-nc/3.0/ or send a
+ * letter to Creative Commons, 444 Castro Street, Suite 900, Mountain View,
+ * California, 94041, USA.
+ */
+/**
+ * @file FlatLink.h
+ * Declaration of the lnet::FlatLink class.
+ */
+#ifndef FLATLINK_H_
+#define FLATLINK_H_
+
+#include <largenet/base/types.h>
+#include <largenet/base/Link.h>
+
+namespace lnet
+{
+
+/**
+ * A network link that remembers its slots in the link lists of its end
+ * nodes. Used together with FlatNode to remove links in constant time.
+ */
+class FlatLink: public Link
+{
+public:
+	/**
+	 * Default constructor
+	 */
+	FlatLink();
+	/**
+	 * Constructor. Creates a link with end node IDs @p source and @p target.
+	 * @param source %Node ID to link from.
+	 * @param target %Node ID to link to.
+	 */
+	FlatLink(node_id_t source, node_id_t target);
+
+	/**
+	 * Get slot of the link in the link list of its source or target node.
+	 * @param atSource If true, return the slot at the source node, else at the
+	 * target node.
+	 * @return Slot in link list.
+	 */
+	id_size_t slot(bool atSource) const;
+	/**
+	 * Set slot of the link in the link list of its source or target node.
+	 * @param atSource If true, set the slot at the source node, else at the
+	 * target node.
+	 * @param slot Slot in link list.
+	 */
+	void setSlot(bool atSource, id_size_t slot);
+
+private:
+	id_size_t sourceSlot_; ///< Slot in the source node's link list
+	id_size_t targetSlot_; ///< Slot in the target node's link list
+};
+
+inline FlatLink::FlatLink() :
+	Link(), sourceSlot_(0), targetSlot_(0)
+{
+}
+
+inline FlatLink::FlatLink(const node_id_t source, const node_id_t target) :
+	Link(source, target), sourceSlot_(0), targetSlot_(0)
+{
+}
+
+inline id_size_t FlatLink::slot(const bool atSource) const
+{
+	return atSource ? sourceSlot_ : targetSlot_;
+}
+
+inline void FlatLink::setSlot(const bool atSource, const id_size_t slot)
+{
+	if (atSource)
+		sourceSlot_ = slot;
+	else
+		targetSlot_ = slot;
+}
+
+}
+
+#endif /* FLATLINK_H_ */
@@ -0,0 +1,242 @@
+/**
+ * This work is licensed under the Creative Commons
+ * Attribution-NonCommercial 3.0 Unported License. To view a copy of this
+ * license, visit http://creativecommons.org/licenses/by-nc/3.0/ or send a
+ * letter to Creative Commons, 444 Castro Street, Suite 900, Mountain View,
+ * California, 94041, USA.
+ */
+/**
+ * @file FlatNode.h
+ * Declaration of the lnet::FlatNode class.
+ */
+#ifndef FLATNODE_H_
+#define FLATNODE_H_
+
+#include <largenet/base/types.h>
+#include <largenet/base/traits.h>
+#include <largenet/base/Adjacency.h>
+#include <vector>
+#include <utility>
+#include <cassert>
+
+namespace lnet
+{
+
+/**
+ * Network node keeping the IDs of adjacent links, together with the IDs of
+ * the nodes at their other ends, in a contiguous array.
+ *
+ * Links are appended at the end of the array and removed by moving the last
+ * entry into the freed slot, so that both operations take constant time as
+ * long as the slot of a link is known. The network keeps track of slots using
+ * FlatLink objects. Since the link list is random access, drawing a random
+ * adjacent link is a single index operation.
+ *
+ * The order of link IDs is unspecified and changes on removal.
+ */
+class FlatNode
+{
+public:
+	typedef std::vector<Adjacency> LinkList;
+	typedef AdjacencyIterator<LinkList::const_iterator> LinkIDIterator; ///< %Link ID iterator type.
+	typedef std::pair<LinkIDIterator, LinkIDIterator> LinkIDIteratorRange; ///< Iterator range type.
+	typedef flat_adjacency_tag adjacency_category;
+
+	/**
+	 * Basic constructor. Creates an isolated node object.
+	 */
+	FlatNode();
+
+	/**
+	 * Return the degree (number of adjacent nodes) of the node.
+	 * @return Degree of the node.
+	 */
+	id_size_t degree() const;
+
+	/**
+	 * Append link with ID @p l to the node's link list.
+	 * @param l %Link ID to add.
+	 * @param neighbor ID of the node at the other end of @p l.
+	 * @return Slot of @p l in the link list.
+	 */
+	id_size_t addLink(link_id_t l, node_id_t neighbor);
+	/**
+	 * Remove the link ID in slot @p slot by moving the last link ID into it.
+	 * @param slot Slot to clear, must be smaller than degree().
+	 * @return ID of the link that now occupies @p slot. If @p slot was the last
+	 * slot, it no longer exists and the removed link ID is returned.
+	 */
+	link_id_t removeLinkAt(id_size_t slot);
+	/**
+	 * Remove link with ID @p l from node. This searches the link list and thus
+	 * takes linear time; prefer removeLinkAt() if the slot is known.
+	 * @param l %Link ID to remove.
+	 */
+	void removeLink(link_id_t l);
+	/**
+	 * Return true if link ID @p l is in the node's link list.
+	 * @param l %Link ID to look for.
+	 * @return True if the link ID is found in the node's link list.
+	 */
+	bool inLink(link_id_t l) const;
+	/**
+	 * Return link ID in slot @p slot.
+	 * @param slot Slot in link list, must be smaller than degree().
+	 * @return %Link ID.
+	 */
+	link_id_t linkAt(id_size_t slot) const;
+	/**
+	 * Return neighbor stored in slot @p slot.
+	 * @param slot Slot in link list, must be smaller than degree().
+	 * @return ID of the node at the other end of linkAt(@p slot).
+	 */
+	node_id_t neighborAt(id_size_t slot) const;
+	/**
+	 * Set the neighbor stored in slot @p slot.
+	 * @param slot Slot in link list, must be smaller than degree().
+	 * @param neighbor ID of the node at the other end of linkAt(@p slot).
+	 */
+	void setNeighbor(id_size_t slot, node_id_t neighbor);
+
+	/**
+	 * Allocate room for @p n links, so that adding links up to this degree
+	 * does not reallocate the link list.
+	 * @param n Number of links.
+	 */
+	void reserve(id_size_t n);
+
+	/**
+	 * Isolate node from neighbors by clearing its link list.
+	 * Note that this does only affect the node, and not its neighbors.
+	 */
+	void clear();
+
+	/**
+	 * Exchange link lists with node @p n without copying.
+	 * @param n %Node to swap with.
+	 */
+	void swap(FlatNode& n);
+
+	/**
+	 * Return iterator range for all IDs of the node's links.
+	 * @return std::pair of LinkIDIterators, the first pointing to the first
+	 * link ID in the node's link list and the second pointing past-the-end
+	 */
+	LinkIDIteratorRange links() const;
+
+private:
+	LinkList links_; ///< Array of links to neighbors
+};
+
+inline FlatNode::FlatNode()
+{
+}
+
+inline id_size_t FlatNode::degree() const
+{
+	return links_.size();
+}
+
+inline id_size_t FlatNode::addLink(const link_id_t l, const node_id_t neighbor)
+{
+	links_.push_back(Adjacency(neighbor, l));
+	return links_.size() - 1;
+}
+
+inline link_id_t FlatNode::removeLinkAt(const id_size_t slot)
+{
+	assert(slot < links_.size());
+	const link_id_t l = links_[slot].link;
+	links_[slot] = links_.back();
+	links_.pop_back();
+	return (slot < links_.size()) ? links_[slot].link : l;
+}
+
+inline void FlatNode::removeLink(const link_id_t l)
+{
+	for (LinkList::iterator it = links_.begin(); it != links_.end(); ++it)
+	{
+		if (it->link == l)
+		{
+			*it = links_.back();
+			links_.pop_back();
+			return;
+		}
+	}
+}
+
+inline bool FlatNode::inLink(const link_id_t l) const
+{
+	for (LinkList::const_iterator it = links_.begin(); it != links_.end(); ++it)
+	{
+		if (it->link == l)
+			return true;
+	}
+	return false;
+}
+
+inline link_id_t FlatNode::linkAt(const id_size_t slot) const
+{
+	assert(slot < links_.size());
+	return links_[slot].link;
+}
+
+inline node_id_t FlatNode::neighborAt(const id_size_t slot) const
+{
+	assert(slot < links_.size());
+	return links_[slot].neighbor;
+}
+
+inline void FlatNode::setNeighbor(const id_size_t slot, const node_id_t neighbor)
+{
+	assert(slot < links_.size());
+	links_[slot].neighbor = neighbor;
+}
+
+inline void FlatNode::reserve(const id_size_t n)
+{
+	links_.reserve(n);
+}
+
+inline void FlatNode::clear()
+{
+	links_.clear();
+}
+
+inline void FlatNode::swap(FlatNode& n)
+{
+	links_.swap(n.links_);
+}
+
+inline FlatNode::LinkIDIteratorRange FlatNode::links() const
+{
+	return std::make_pair(LinkIDIterator(links_.begin()),
+			LinkIDIterator(links_.end()));
+}
+
+inline void swap(FlatNode& a, FlatNode& b)
+{
+	a.swap(b);
+}
+
+/**
+ * Reset a removed node in place (see repo::resetItem()). The node keeps its
+ * allocated link array for reuse.
+ * @param n %Node to reset.
+ */
+inline void resetItem(FlatNode& n)
+{
+	n.clear();
+}
+
+/**
+ * Set up a new node in a free repository slot (see repo::emplaceItem()). The
+ * slot holds a reset node already, which is kept along with its link array.
+ */
+inline void emplaceItem(FlatNode&)
+{
+}
+
+}
+
+#endif /* FLATNODE_H_ */
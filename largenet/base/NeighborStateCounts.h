@@ -0,0 +1,156 @@
+/**
+ * This work is licensed under the Creative Commons
+ * Attribution-NonCommercial 3.0 Unported License. To view a copy of this
+ * license, visit http://creativecommons.org/licenses/by-nc/3.0/ or send a
+ * letter to Creative Commons, 444 Castro Street, Suite 900, Mountain View,
+ * California, 94041, USA.
+ */
+/**
+ * @file NeighborStateCounts.h
+ * Declaration of the lnet::NeighborStateCounts class.
+ */
+#ifndef NEIGHBORSTATECOUNTS_H_
+#define NEIGHBORSTATECOUNTS_H_
+
+#include <largenet/base/types.h>
+#include <vector>
+#include <algorithm>
+#include <cassert>
+
+namespace lnet
+{
+
+/**
+ * Number of neighbors in each node state, for every node.
+ *
+ * The counts of a node are stored contiguously in one table row of length
+ * numberOfStates(), indexed by node ID. Neighbors are counted with
+ * multiplicity, i.e. as often as they appear in the node's neighbor list, so
+ * a self-loop adds two to its node's own state.
+ */
+class NeighborStateCounts
+{
+public:
+	/**
+	 * Constructor.
+	 * @param nStates Number of node states.
+	 */
+	explicit NeighborStateCounts(node_state_size_t nStates);
+
+	/**
+	 * Return number of neighbors of node @p n in state @p s.
+	 * @param n %Node ID
+	 * @param s %Node state
+	 */
+	id_size_t count(node_id_t n, node_state_t s) const;
+	/**
+	 * Count one more neighbor of node @p n in state @p s.
+	 * @param n %Node ID
+	 * @param s %Node state
+	 */
+	void increment(node_id_t n, node_state_t s);
+	/**
+	 * Count one neighbor less of node @p n in state @p s.
+	 * @param n %Node ID
+	 * @param s %Node state
+	 */
+	void decrement(node_id_t n, node_state_t s);
+	/**
+	 * Move one neighbor of node @p n from state @p from to state @p to.
+	 * @param n %Node ID
+	 * @param from Old state of the neighbor.
+	 * @param to New state of the neighbor.
+	 */
+	void move(node_id_t n, node_state_t from, node_state_t to);
+	/**
+	 * Set all counts of node @p n to zero, making room for it if necessary.
+	 * @param n %Node ID
+	 */
+	void clear(node_id_t n);
+
+	/**
+	 * Set all counts to zero.
+	 */
+	void clear();
+	/**
+	 * Return number of node states.
+	 */
+	node_state_size_t numberOfStates() const;
+	/**
+	 * Return memory used by the table in bytes.
+	 */
+	id_size_t memoryUsage() const;
+
+private:
+	id_size_t index(node_id_t n, node_state_t s) const;
+
+	node_state_size_t nStates_; ///< row length
+	std::vector<id_size_t> counts_; ///< counts of node n start at n * nStates_
+};
+
+inline NeighborStateCounts::NeighborStateCounts(const node_state_size_t nStates) :
+	nStates_(nStates)
+{
+}
+
+inline id_size_t NeighborStateCounts::index(const node_id_t n,
+		const node_state_t s) const
+{
+	assert(s < nStates_);
+	assert((n + 1) * nStates_ <= counts_.size());
+	return n * nStates_ + s;
+}
+
+inline id_size_t NeighborStateCounts::count(const node_id_t n,
+		const node_state_t s) const
+{
+	return counts_[index(n, s)];
+}
+
+inline void NeighborStateCounts::increment(const node_id_t n,
+		const node_state_t s)
+{
+	++counts_[index(n, s)];
+}
+
+inline void NeighborStateCounts::decrement(const node_id_t n,
+		const node_state_t s)
+{
+	assert(counts_[index(n, s)] > 0);
+	--counts_[index(n, s)];
+}
+
+inline void NeighborStateCounts::move(const node_id_t n,
+		const node_state_t from, const node_state_t to)
+{
+	decrement(n, from);
+	increment(n, to);
+}
+
+inline void NeighborStateCounts::clear(const node_id_t n)
+{
+	if ((n + 1) * nStates_ > counts_.size())
+		counts_.resize((n + 1) * nStates_);
+	else
+		std::fill(counts_.begin() + n * nStates_,
+				counts_.begin() + (n + 1) * nStates_, 0);
+}
+
+inline void NeighborStateCounts::clear()
+{
+	std::fill(counts_.begin(), counts_.end(), 0);
+}
+
+inline node_state_size_t NeighborStateCounts::numberOfStates() const
+{
+	return nStates_;
+}
+
+inline id_size_t NeighborStateCounts::memoryUsage() const
+{
+	return counts_.capacity() * sizeof(id_size_t);
+}
+
+}
+
+#endif /* NEIGHBORSTATECOUNTS_H_ */
@@ -15,6 +15,8 @@
 #define NODE_H_
 
 #include <largenet/base/types.h>
+#include <largenet/base/traits.h>
+#include <largenet/base/Adjacency.h>
 #include <set>
 #include <utility>
 
@@ -24,14 +26,16 @@ namespace lnet
 /**
  * Class representing one network node.
  *
- * A %Node keeps a list of the IDs of adjacent links.
+ * A %Node keeps a list of the IDs of adjacent links, ordered by link ID,
+ * together with the IDs of the nodes at their other ends.
  */
 class Node
 {
 public:
-	typedef std::multiset<link_id_t> LinkSet;
-	typedef LinkSet::iterator LinkIDIterator; ///< %Link ID iterator type.
+	typedef std::multiset<Adjacency, AdjacencyLinkOrder> LinkSet;
+	typedef AdjacencyIterator<LinkSet::const_iterator> LinkIDIterator; ///< %Link ID iterator type.
 	typedef std::pair<LinkIDIterator, LinkIDIterator> LinkIDIteratorRange; ///< Iterator range type.
+	typedef set_adjacency_tag adjacency_category;
 
 	/**
 	 * Basic constructor. Creates an isolated node object.
@@ -48,14 +52,21 @@ public:
 	 * Add link with ID @p l to node. The link ID is inserted in the node's link
 	 * list, thus increasing the node's degree by one.
 	 * @param l %Link ID to add.
+	 * @param neighbor ID of the node at the other end of @p l.
 	 */
-	void addLink(link_id_t l);
+	void addLink(link_id_t l, node_id_t neighbor);
 	/**
 	 * Remove link with ID @p l from node. The link ID is removed from the node's
 	 * link list, thus decreasing the node's degree by one.
 	 * @param l %Link ID to remove.
 	 */
 	void removeLink(link_id_t l);
+	/**
+	 * Set the neighbor stored with link @p l.
+	 * @param l %Link ID.
+	 * @param neighbor ID of the node at the other end of @p l.
+	 */
+	void setNeighbor(link_id_t l, node_id_t neighbor);
 	/**
 	 * Return true if link ID @p l is in the node's link list.
 	 * @param l %Link ID to look for.
@@ -69,12 +80,18 @@ public:
 	 */
 	void clear();
 
+	/**
+	 * Exchange link lists with node @p n without copying.
+	 * @param n %Node to swap with.
+	 */
+	void swap(Node& n);
+
 	/**
 	 * Return iterator range for all IDs of the node's links.
 	 * @return std::pair of LinkIDIterators, the first pointing to the first
 	 * link ID in the node's link list and the second pointing past-the-end
 	 */
-	LinkIDIteratorRange links();
+	LinkIDIteratorRange links() const;
 
 private:
 	LinkSet links_; ///< Multiset of links to neighbors
@@ -84,26 +101,36 @@ inline Node::Node()
 {
 }
 
-inline void Node::addLink(const link_id_t l)
+inline void Node::addLink(const link_id_t l, const node_id_t neighbor)
 {
-	links_.insert(l);
+	// new links usually have the largest ID, so try the end first
+	links_.insert(links_.end(), Adjacency(neighbor, l));
 }
 
 inline void Node::removeLink(const link_id_t l)
 {
-	LinkSet::iterator it = links_.find(l);
+	LinkSet::iterator it = links_.find(Adjacency(0, l));
 	if (it != links_.end())
 		links_.erase(it);
 }
 
+inline void Node::setNeighbor(const link_id_t l, const node_id_t neighbor)
+{
+	std::pair<LinkSet::iterator, LinkSet::iterator> range = links_.equal_range(
+			Adjacency(0, l));
+	for (; range.first != range.second; ++range.first)
+		range.first->neighbor = neighbor;
+}
+
 inline id_size_t Node::degree() const
 {
 	return links_.size();
 }
 
-inline Node::LinkIDIteratorRange Node::links()
+inline Node::LinkIDIteratorRange Node::links() const
 {
-	return std::make_pair(links_.begin(), links_.end());
+	return std::make_pair(LinkIDIterator(links_.begin()),
+			LinkIDIterator(links_.end()));
 }
 
 inline void Node::clear()
@@ -113,7 +140,26 @@ inline void Node::clear()
 
 inline bool Node::inLink(const link_id_t l) const
 {
-	return links_.find(l) != links_.end();
+	return links_.find(Adjacency(0, l)) != links_.end();
+}
+
+inline void Node::swap(Node& n)
+{
+	links_.swap(n.links_);
+}
+
+inline void swap(Node& a, Node& b)
+{
+	a.swap(b);
+}
+
+/**
+ * Reset a removed node in place (see repo::resetItem()).
+ * @param n %Node to reset.
+ */
+inline void resetItem(Node& n)
+{
+	n.clear();
 }
 
 }
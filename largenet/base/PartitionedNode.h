@@ -0,0 +1,328 @@
+/**
+ * This work is licensed under the Creative Commons
+ * Attribution-NonCommercial 3.0 Unported License. To view a copy of this
+ * license, visit http://creativecommons.org/licenses/by-nc/3.0/ or send a
+ * letter to Creative Commons, 444 Castro Street, Suite 900, Mountain View,
+ * California, 94041, USA.
+ */
+/**
+ * @file PartitionedNode.h
+ * Declaration of the lnet::PartitionedNode class.
+ */
+#ifndef PARTITIONEDNODE_H_
+#define PARTITIONEDNODE_H_
+
+#include <largenet/base/types.h>
+#include <largenet/base/traits.h>
+#include <largenet/base/Adjacency.h>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cassert>
+
+namespace lnet
+{
+
+/**
+ * Network node keeping its adjacent links in a contiguous array that is
+ * partitioned into groups, like a small repo::CategorizedRepository.
+ *
+ * Each group occupies a contiguous block of the array, and blocks are ordered
+ * by group number. Adding a link to group @c g or removing it moves one entry
+ * for each group behind @c g, so these operations take time linear in the
+ * number of groups, but independent of the degree. Entries that are moved
+ * are reported to an observer, which is called as
+ * @code
+ * obs(l, g, slot);
+ * @endcode
+ * with the link ID, group, and new slot of the moved entry. The network uses
+ * this to keep the slots stored in FlatLink objects up to date.
+ *
+ * Drawing a random link from a given group is a single index operation. The
+ * network groups links by the state of the neighbor and by the link direction
+ * (see TypedNetwork).
+ */
+class PartitionedNode
+{
+public:
+	typedef std::vector<Adjacency> LinkList;
+	typedef AdjacencyIterator<LinkList::const_iterator> LinkIDIterator; ///< %Link ID iterator type.
+	typedef std::pair<LinkIDIterator, LinkIDIterator> LinkIDIteratorRange; ///< Iterator range type.
+	typedef partitioned_adjacency_tag adjacency_category;
+
+	/**
+	 * Basic constructor. Creates an isolated node object.
+	 */
+	PartitionedNode();
+
+	/**
+	 * Return the degree (number of adjacent nodes) of the node.
+	 * @return Degree of the node.
+	 */
+	id_size_t degree() const;
+	/**
+	 * Return number of links in group @p g.
+	 * @param g Group number.
+	 */
+	id_size_t count(id_size_t g) const;
+	/**
+	 * Return group of the link in slot @p slot.
+	 * @param slot Slot in link list, must be smaller than degree().
+	 */
+	id_size_t groupAt(id_size_t slot) const;
+
+	/**
+	 * Add link with ID @p l to group @p g.
+	 * @param l %Link ID to add.
+	 * @param neighbor ID of the node at the other end of @p l.
+	 * @param g Group to add the link to.
+	 * @param obs Observer notified of moved entries.
+	 * @return Slot of @p l in the link list.
+	 */
+	template<class _Observer>
+	id_size_t addLink(link_id_t l, node_id_t neighbor, id_size_t g,
+			_Observer& obs);
+	/**
+	 * Remove the link in slot @p slot.
+	 * @param slot Slot to clear, must be smaller than degree().
+	 * @param obs Observer notified of moved entries.
+	 */
+	template<class _Observer>
+	void removeLinkAt(id_size_t slot, _Observer& obs);
+	/**
+	 * Move the link in slot @p slot to group @p g.
+	 * @param slot Slot of the link, must be smaller than degree().
+	 * @param g New group of the link.
+	 * @param obs Observer notified of moved entries, not including the link
+	 * in @p slot itself.
+	 * @return New slot of the link.
+	 */
+	template<class _Observer>
+	id_size_t moveLinkAt(id_size_t slot, id_size_t g, _Observer& obs);
+
+	/**
+	 * Return link ID in slot @p slot.
+	 * @param slot Slot in link list, must be smaller than degree().
+	 * @return %Link ID.
+	 */
+	link_id_t linkAt(id_size_t slot) const;
+	/**
+	 * Return slot of the @p i-th link in group @p g.
+	 * @param g Group number.
+	 * @param i Number of link in group, must be smaller than count(@p g).
+	 */
+	id_size_t slotInGroup(id_size_t g, id_size_t i) const;
+	/**
+	 * Return neighbor stored in slot @p slot.
+	 * @param slot Slot in link list, must be smaller than degree().
+	 * @return ID of the node at the other end of linkAt(@p slot).
+	 */
+	node_id_t neighborAt(id_size_t slot) const;
+	/**
+	 * Set the link ID stored in slot @p slot, keeping its group.
+	 * @param slot Slot in link list, must be smaller than degree().
+	 * @param l %Link ID
+	 */
+	void setLink(id_size_t slot, link_id_t l);
+	/**
+	 * Set the neighbor stored in slot @p slot, keeping its group.
+	 * @param slot Slot in link list, must be smaller than degree().
+	 * @param neighbor ID of the node at the other end of linkAt(@p slot).
+	 */
+	void setNeighbor(id_size_t slot, node_id_t neighbor);
+
+	/**
+	 * Allocate room for @p n links, so that adding links up to this degree
+	 * does not reallocate the link list.
+	 * @param n Number of links.
+	 */
+	void reserve(id_size_t n);
+
+	/**
+	 * Isolate node from neighbors by clearing its link list.
+	 * Note that this does only affect the node, and not its neighbors.
+	 */
+	void clear();
+
+	/**
+	 * Exchange link lists with node @p n without copying.
+	 * @param n %Node to swap with.
+	 */
+	void swap(PartitionedNode& n);
+
+	/**
+	 * Return iterator range for all IDs of the node's links, ordered by group.
+	 * @return std::pair of LinkIDIterators, the first pointing to the first
+	 * link ID in the node's link list and the second pointing past-the-end
+	 */
+	LinkIDIteratorRange links() const;
+
+private:
+	LinkList links_; ///< Array of links to neighbors, ordered by group
+	std::vector<id_size_t> bounds_; ///< group g occupies [bounds_[g], bounds_[g + 1]); empty if there are no groups yet
+};
+
+inline PartitionedNode::PartitionedNode()
+{
+}
+
+inline id_size_t PartitionedNode::degree() const
+{
+	return links_.size();
+}
+
+inline id_size_t PartitionedNode::count(const id_size_t g) const
+{
+	return (g + 1 < bounds_.size()) ? bounds_[g + 1] - bounds_[g] : 0;
+}
+
+inline id_size_t PartitionedNode::groupAt(const id_size_t slot) const
+{
+	assert(slot < links_.size());
+	return std::upper_bound(bounds_.begin(), bounds_.end(), slot)
+			- bounds_.begin() - 1;
+}
+
+template<class _Observer>
+id_size_t PartitionedNode::addLink(const link_id_t l,
+		const node_id_t neighbor, const id_size_t g, _Observer& obs)
+{
+	if (bounds_.empty())
+		bounds_.push_back(0);
+	while (bounds_.size() < g + 2)
+		bounds_.push_back(links_.size());
+	// open a hole at the end and pass it down to the end of group g by
+	// moving the first entry of each group behind g to its end
+	links_.push_back(Adjacency(neighbor, l));
+	id_size_t hole = links_.size() - 1;
+	for (id_size_t h = bounds_.size() - 2; h > g; --h)
+	{
+		if (bounds_[h] != bounds_[h + 1])
+		{
+			links_[hole] = links_[bounds_[h]];
+			obs(links_[hole].link, h, hole);
+			hole = bounds_[h];
+		}
+		++bounds_[h + 1];
+	}
+	++bounds_[g + 1];
+	links_[hole] = Adjacency(neighbor, l);
+	return hole;
+}
+
+template<class _Observer>
+void PartitionedNode::removeLinkAt(const id_size_t slot, _Observer& obs)
+{
+	assert(slot < links_.size());
+	const id_size_t g = groupAt(slot);
+	// fill the hole with the last entry of group g, then pass it up to the end
+	// by moving the last entry of each group behind g to its front
+	id_size_t hole = slot;
+	for (id_size_t h = g; h + 1 < bounds_.size(); ++h)
+	{
+		// for an empty group, last is the hole itself
+		const id_size_t last = bounds_[h + 1] - 1;
+		if (last != hole)
+		{
+			links_[hole] = links_[last];
+			obs(links_[hole].link, h, hole);
+		}
+		hole = last;
+		--bounds_[h + 1];
+	}
+	assert(hole == links_.size() - 1);
+	links_.pop_back();
+}
+
+template<class _Observer>
+id_size_t PartitionedNode::moveLinkAt(const id_size_t slot, const id_size_t g,
+		_Observer& obs)
+{
+	const Adjacency a = links_[slot];
+	if (groupAt(slot) == g)
+		return slot;
+	removeLinkAt(slot, obs);
+	return addLink(a.link, a.neighbor, g, obs);
+}
+
+inline link_id_t PartitionedNode::linkAt(const id_size_t slot) const
+{
+	assert(slot < links_.size());
+	return links_[slot].link;
+}
+
+inline id_size_t PartitionedNode::slotInGroup(const id_size_t g,
+		const id_size_t i) const
+{
+	assert(i < count(g));
+	return bounds_[g] + i;
+}
+
+inline node_id_t PartitionedNode::neighborAt(const id_size_t slot) const
+{
+	assert(slot < links_.size());
+	return links_[slot].neighbor;
+}
+
+inline void PartitionedNode::setLink(const id_size_t slot, const link_id_t l)
+{
+	assert(slot < links_.size());
+	links_[slot].link = l;
+}
+
+inline void PartitionedNode::setNeighbor(const id_size_t slot,
+		const node_id_t neighbor)
+{
+	assert(slot < links_.size());
+	links_[slot].neighbor = neighbor;
+}
+
+inline void PartitionedNode::reserve(const id_size_t n)
+{
+	links_.reserve(n);
+}
+
+inline void PartitionedNode::clear()
+{
+	links_.clear();
+	bounds_.clear();
+}
+
+inline void PartitionedNode::swap(PartitionedNode& n)
+{
+	links_.swap(n.links_);
+	bounds_.swap(n.bounds_);
+}
+
+inline PartitionedNode::LinkIDIteratorRange PartitionedNode::links() const
+{
+	return std::make_pair(LinkIDIterator(links_.begin()),
+			LinkIDIterator(links_.end()));
+}
+
+inline void swap(PartitionedNode& a, PartitionedNode& b)
+{
+	a.swap(b);
+}
+
+/**
+ * Reset a removed node in place (see repo::resetItem()). The node keeps its
+ * allocated link array for reuse.
+ * @param n %Node to reset.
+ */
+inline void resetItem(PartitionedNode& n)
+{
+	n.clear();
+}
+
+/**
+ * Set up a new node in a free repository slot (see repo::emplaceItem()). The
+ * slot holds a reset node already, which is kept along with its link array.
+ */
+inline void emplaceItem(PartitionedNode&)
+{
+}
+
+}
+
+#endif /* PARTITIONEDNODE_H_ */
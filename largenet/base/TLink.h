@@ -12,6 +12,7 @@
 #include <largenet/base/types.h>
 #include <largenet/base/Link.h>
 #include <set>
+#include <algorithm>
 #include <utility>
 
 namespace lnet
@@ -92,6 +93,12 @@ public:
 	 */
 	void clear();
 
+	/**
+	 * Exchange contents with link @p l without copying the triple set.
+	 * @param l %Link to swap with.
+	 */
+	void swap(TLink& l);
+
 	/**
 	 * Insert triple ID @p t into the link's triple set.
 	 * @param t %Triple ID
@@ -172,9 +179,32 @@ inline void TLink::clear()
 	triples_.clear();
 }
 
+inline void TLink::swap(TLink& l)
+{
+	std::swap(link_, l.link_);
+	triples_.swap(l.triples_);
+}
+
+inline void swap(TLink& a, TLink& b)
+{
+	a.swap(b);
+}
+
+/**
+ * Reset a removed link in place (see repo::resetItem()).
+ * @param l %Link to reset.
+ */
+inline void resetItem(TLink& l)
+{
+	l.clear();
+	l.setSource(0);
+	l.setTarget(0);
+}
+
 inline void TLink::addTriple(const triple_id_t t)
 {
-	triples_.insert(t);
+	// new triples usually have the largest ID, so try the end first
+	triples_.insert(triples_.end(), t);
 }
 
 inline void TLink::removeTriple(const triple_id_t t)
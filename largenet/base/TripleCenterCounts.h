@@ -0,0 +1,369 @@
+/**
+ * This work is licensed under the Creative Commons
+ * Attribution-NonCommercial 3.0 Unported License. To view a copy of this
+ * license, visit http://creativecommons.org/licenses/by-nc/3.0/ or send a
+ * letter to Creative Commons, 444 Castro Street, Suite 900, Mountain View,
+ * California, 94041, USA.
+ */
+/**
+ * @file TripleCenterCounts.h
+ * Declaration of the lnet::TripleCenterCounts class.
+ */
+#ifndef TRIPLECENTERCOUNTS_H_
+#define TRIPLECENTERCOUNTS_H_
+
+#include <largenet/base/types.h>
+#include <largenet/base/state_calculators.h>
+#include <vector>
+#include <algorithm>
+#include <cassert>
+
+namespace lnet
+{
+
+/**
+ * Number of triples centered at each node, by triple state, without storing
+ * the triples themselves.
+ *
+ * The triples centered at node c are the pairs of entries in its link list.
+ * Their states depend only on the state of c and the states of the two
+ * neighbors, so they are counted per unordered pair (a, b) of neighbor
+ * states from the number of neighbors of c in each state (see
+ * NeighborStateCounts). The two ends of a self-loop are both listed, but do
+ * not form a triple with each other; self-loops are therefore counted
+ * separately.
+ *
+ * For each triple state, a Fenwick tree over node IDs sums up the triples
+ * centered at each node. The number of triples in a state takes constant
+ * time, and drawing a center node with probability proportional to its
+ * number of triples takes time logarithmic in the number of nodes. Memory
+ * does not depend on the number of triples.
+ *
+ * As the neighbor state pairs are unordered, the triple state calculator
+ * must give the same state for (a, c, b) and (b, c, a) (see isSymmetric()).
+ */
+class TripleCenterCounts
+{
+public:
+	/**
+	 * Constructor.
+	 * @param tsCalc Symmetric triple state calculator.
+	 * @param nNodeStates Number of node states.
+	 */
+	TripleCenterCounts(const TripleStateCalculator& tsCalc,
+			node_state_size_t nNodeStates);
+
+	/**
+	 * Return true if @p tsCalc gives the same state for (a, c, b) and
+	 * (b, c, a) for all node states a, b, c.
+	 * @param tsCalc Triple state calculator.
+	 * @param nNodeStates Number of node states.
+	 */
+	static bool isSymmetric(const TripleStateCalculator& tsCalc,
+			node_state_size_t nNodeStates);
+
+	/**
+	 * Return number of triples in state @p s.
+	 * @param s %Triple state
+	 */
+	id_size_t count(triple_state_t s) const;
+	/**
+	 * Return number of triples.
+	 */
+	id_size_t count() const;
+
+	/**
+	 * Recount the triples centered at node @p n.
+	 * @param n %Node ID
+	 * @param s State of node @p n.
+	 * @param neighbors Number of neighbors of @p n in each node state.
+	 */
+	void update(node_id_t n, node_state_t s,
+			const std::vector<id_size_t>& neighbors);
+	/**
+	 * Count one more self-loop at node @p n. Call update() for @p n
+	 * afterwards.
+	 * @param n %Node ID
+	 */
+	void addSelfLoop(node_id_t n);
+	/**
+	 * Count one self-loop less at node @p n. Call update() for @p n
+	 * afterwards.
+	 * @param n %Node ID
+	 */
+	void removeSelfLoop(node_id_t n);
+	/**
+	 * Set all counts of node @p n to zero, making room for it if necessary.
+	 * @param n %Node ID
+	 */
+	void clear(node_id_t n);
+	/**
+	 * Set all counts to zero and make room for @p nNodes nodes.
+	 * @param nNodes Number of node IDs.
+	 */
+	void reset(id_size_t nNodes);
+
+	/**
+	 * Find the @p x 'th triple in state @p s, where triples are numbered by
+	 * center node ID, then by pair of neighbor states. Drawing @p x
+	 * uniformly from [0, count(@p s)) picks a center node with probability
+	 * proportional to its number of triples in state @p s.
+	 * @param s %Triple state
+	 * @param x Number of triple, smaller than count(@p s).
+	 * @param[out] n Center node.
+	 * @param[out] a State of one neighbor.
+	 * @param[out] b State of the other neighbor, not smaller than @p a.
+	 */
+	void locate(triple_state_t s, id_size_t x, node_id_t& n, node_state_t& a,
+			node_state_t& b) const;
+
+	/**
+	 * Return number of triple states.
+	 */
+	triple_state_size_t numberOfTripleStates() const;
+	/**
+	 * Return memory used by the counts in bytes.
+	 */
+	id_size_t memoryUsage() const;
+
+private:
+	triple_state_t tripleState(node_state_t c, id_size_t p) const;
+	void grow(node_id_t n);
+	void add(triple_state_t s, node_id_t n, id_size_t w);
+	void subtract(triple_state_t s, node_id_t n, id_size_t w);
+
+	node_state_size_t nNodeStates_;
+	id_size_t nPairs_; ///< number of unordered neighbor state pairs
+	std::vector<node_state_t> pairA_, pairB_; ///< neighbor states of each pair
+	std::vector<triple_state_t> states_; ///< triple state of pair p around a center in state c at c * nPairs_ + p
+	std::vector<id_size_t> totals_; ///< number of triples in each triple state
+	std::vector<std::vector<id_size_t> > trees_; ///< Fenwick tree of triples by center node, for each triple state
+	std::vector<id_size_t> pairs_; ///< triples of node n by neighbor state pair start at n * nPairs_
+	std::vector<node_state_t> centers_; ///< state of each node when its triples were counted
+	std::vector<id_size_t> loops_; ///< number of self-loops at each node
+};
+
+inline TripleCenterCounts::TripleCenterCounts(
+		const TripleStateCalculator& tsCalc,
+		const node_state_size_t nNodeStates) :
+	nNodeStates_(nNodeStates), nPairs_(nNodeStates * (nNodeStates + 1) / 2),
+			totals_(tsCalc.numberOfTripleStates(), 0), trees_(
+					tsCalc.numberOfTripleStates(),
+					std::vector<id_size_t>(1, 0))
+{
+	assert(isSymmetric(tsCalc, nNodeStates));
+	for (node_state_t a = 0; a < nNodeStates; ++a)
+	{
+		for (node_state_t b = a; b < nNodeStates; ++b)
+		{
+			pairA_.push_back(a);
+			pairB_.push_back(b);
+		}
+	}
+	states_.resize(nNodeStates * nPairs_);
+	for (node_state_t c = 0; c < nNodeStates; ++c)
+		for (id_size_t p = 0; p < nPairs_; ++p)
+			states_[c * nPairs_ + p] = tsCalc(pairA_[p], c, pairB_[p]);
+}
+
+inline bool TripleCenterCounts::isSymmetric(
+		const TripleStateCalculator& tsCalc,
+		const node_state_size_t nNodeStates)
+{
+	for (node_state_t a = 0; a < nNodeStates; ++a)
+		for (node_state_t b = a + 1; b < nNodeStates; ++b)
+			for (node_state_t c = 0; c < nNodeStates; ++c)
+				if (tsCalc(a, c, b) != tsCalc(b, c, a))
+					return false;
+	return true;
+}
+
+inline triple_state_t TripleCenterCounts::tripleState(const node_state_t c,
+		const id_size_t p) const
+{
+	return states_[c * nPairs_ + p];
+}
+
+inline id_size_t TripleCenterCounts::count(const triple_state_t s) const
+{
+	assert(s < totals_.size());
+	return totals_[s];
+}
+
+inline id_size_t TripleCenterCounts::count() const
+{
+	id_size_t sum = 0;
+	for (std::vector<id_size_t>::const_iterator it = totals_.begin(); it
+			!= totals_.end(); ++it)
+		sum += *it;
+	return sum;
+}
+
+inline void TripleCenterCounts::grow(const node_id_t n)
+{
+	if (n < centers_.size())
+		return;
+	for (std::vector<std::vector<id_size_t> >::iterator t = trees_.begin(); t
+			!= trees_.end(); ++t)
+	{
+		std::vector<id_size_t>& tree = *t;
+		// a new tree node sums up the nodes covering the preceding range
+		for (id_size_t k = tree.size(); k <= n + 1; ++k)
+		{
+			const id_size_t stop = k - (k & (~k + 1));
+			id_size_t sum = 0;
+			for (id_size_t i = k - 1; i > stop; i -= i & (~i + 1))
+				sum += tree[i];
+			tree.push_back(sum);
+		}
+	}
+	pairs_.resize((n + 1) * nPairs_, 0);
+	centers_.resize(n + 1, 0);
+	loops_.resize(n + 1, 0);
+}
+
+inline void TripleCenterCounts::add(const triple_state_t s, const node_id_t n,
+		const id_size_t w)
+{
+	std::vector<id_size_t>& tree = trees_[s];
+	for (id_size_t i = n + 1; i < tree.size(); i += i & (~i + 1))
+		tree[i] += w;
+	totals_[s] += w;
+}
+
+inline void TripleCenterCounts::subtract(const triple_state_t s,
+		const node_id_t n, const id_size_t w)
+{
+	std::vector<id_size_t>& tree = trees_[s];
+	for (id_size_t i = n + 1; i < tree.size(); i += i & (~i + 1))
+		tree[i] -= w;
+	totals_[s] -= w;
+}
+
+inline void TripleCenterCounts::update(const node_id_t n, const node_state_t s,
+		const std::vector<id_size_t>& neighbors)
+{
+	assert(s < nNodeStates_);
+	assert(neighbors.size() >= nNodeStates_);
+	grow(n);
+	id_size_t* row = &pairs_[n * nPairs_];
+	const node_state_t old = centers_[n];
+	for (id_size_t p = 0; p < nPairs_; ++p)
+	{
+		const node_state_t a = pairA_[p], b = pairB_[p];
+		id_size_t w;
+		if (a != b)
+			w = neighbors[a] * neighbors[b];
+		else
+		{
+			w = neighbors[a] * (neighbors[a] - 1) / 2;
+			// the two ends of a self-loop
+			if (a == s)
+				w -= loops_[n];
+		}
+		if (old != s)
+		{
+			if (row[p] > 0)
+				subtract(tripleState(old, p), n, row[p]);
+			if (w > 0)
+				add(tripleState(s, p), n, w);
+		}
+		else if (w > row[p])
+			add(tripleState(s, p), n, w - row[p]);
+		else if (w < row[p])
+			subtract(tripleState(s, p), n, row[p] - w);
+		row[p] = w;
+	}
+	centers_[n] = s;
+}
+
+inline void TripleCenterCounts::addSelfLoop(const node_id_t n)
+{
+	grow(n);
+	++loops_[n];
+}
+
+inline void TripleCenterCounts::removeSelfLoop(const node_id_t n)
+{
+	assert((n < loops_.size()) && (loops_[n] > 0));
+	--loops_[n];
+}
+
+inline void TripleCenterCounts::clear(const node_id_t n)
+{
+	grow(n);
+	id_size_t* row = &pairs_[n * nPairs_];
+	for (id_size_t p = 0; p < nPairs_; ++p)
+	{
+		if (row[p] > 0)
+			subtract(tripleState(centers_[n], p), n, row[p]);
+		row[p] = 0;
+	}
+	loops_[n] = 0;
+}
+
+inline void TripleCenterCounts::reset(const id_size_t nNodes)
+{
+	for (std::vector<std::vector<id_size_t> >::iterator t = trees_.begin(); t
+			!= trees_.end(); ++t)
+		t->assign(nNodes + 1, 0);
+	std::fill(totals_.begin(), totals_.end(), 0);
+	pairs_.assign(nNodes * nPairs_, 0);
+	centers_.assign(nNodes, 0);
+	loops_.assign(nNodes, 0);
+}
+
+inline void TripleCenterCounts::locate(const triple_state_t s, id_size_t x,
+		node_id_t& n, node_state_t& a, node_state_t& b) const
+{
+	assert(x < count(s));
+	const std::vector<id_size_t>& tree = trees_[s];
+	const id_size_t size = tree.size() - 1;
+	id_size_t pos = 0, step = 1;
+	while (2 * step <= size)
+		step *= 2;
+	for (; step > 0; step /= 2)
+	{
+		if ((pos + step <= size) && (tree[pos + step] <= x))
+		{
+			pos += step;
+			x -= tree[pos];
+		}
+	}
+	assert(pos < size);
+	n = pos;
+	const id_size_t* row = &pairs_[n * nPairs_];
+	for (id_size_t p = 0; p < nPairs_; ++p)
+	{
+		if (tripleState(centers_[n], p) != s)
+			continue;
+		if (x < row[p])
+		{
+			a = pairA_[p];
+			b = pairB_[p];
+			return;
+		}
+		x -= row[p];
+	}
+	assert(false);
+}
+
+inline triple_state_size_t TripleCenterCounts::numberOfTripleStates() const
+{
+	return totals_.size();
+}
+
+inline id_size_t TripleCenterCounts::memoryUsage() const
+{
+	id_size_t bytes = (pairs_.capacity() + loops_.capacity()
+			+ totals_.capacity()) * sizeof(id_size_t) + centers_.capacity()
+			* sizeof(node_state_t);
+	for (std::vector<std::vector<id_size_t> >::const_iterator t =
+			trees_.begin(); t != trees_.end(); ++t)
+		bytes += t->capacity() * sizeof(id_size_t);
+	return bytes;
+}
+
+}
+
+#endif /* TRIPLECENTERCOUNTS_H_ */
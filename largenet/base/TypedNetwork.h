@@ -17,6 +17,9 @@
 #include <largenet/base/BasicNetwork.h>
 #include <largenet/base/types.h>
 #include <largenet/base/traits.h>
+#include <largenet/base/EdgeIndex.h>
+#include <largenet/base/EndpointTable.h>
+#include <largenet/base/NeighborStateCounts.h>
 #include <largenet/base/repo/CategorizedRepository.h>
 #include <largenet/myrng/myrngWELL.h>
 #include <iterator>
@@ -24,14 +27,31 @@
 #include <utility> // for std::pair
 #include <string>
 #include <sstream>
+#include <stdexcept>
+#include <vector>
+#include <algorithm>
 
 namespace lnet
 {
 /**
  * Abstract base class template providing the common network interface. The @p _Node and @p _Link types
  * must implement the Node and Link concepts.
+ *
+ * @p _LinkStates is the type of link state calculator the network works with. The default,
+ * LinkStateCalculator, accepts any calculator and calls it through its virtual interface, so
+ * that it can be exchanged at runtime. Any other type must be derived from LinkStateCalculator
+ * and provide a non-virtual member function
+ * @code
+ * link_state_t lookup(node_state_t source, node_state_t target) const;
+ * @endcode
+ * like LinkStateTable, DefaultLinkStateCalculator, and FixedLinkStateTable do. The network
+ * then calls lookup() directly, so that it can be inlined into the loops recalculating link
+ * states, and only accepts calculators of type @p _LinkStates. Passing any other calculator
+ * throws a std::invalid_argument exception. If no calculator is given, the network uses a
+ * DefaultLinkStateCalculator if that is a @p _LinkStates, and a default-constructed
+ * @p _LinkStates otherwise, so @p _LinkStates must then be default-constructible.
  */
-template<class _Node, class _Link>
+template<class _Node, class _Link, class _LinkStates = LinkStateCalculator>
 class TypedNetwork: public BasicNetwork
 {
 protected:
@@ -70,7 +90,7 @@ public:
 		 * @param val Current value (index in the nodes link list).
 		 */
 		NeighborIterator(const TypedNetwork& net, node_id_t n,
-				typename NodeType::LinkSet::iterator val);
+				typename NodeType::LinkIDIterator val);
 		/**
 		 * Copy constructor.
 		 * @param it %NeighborIterator to copy.
@@ -115,9 +135,9 @@ public:
 		 */
 		node_id_t operator*();
 	private:
-		const TypedNetwork<NodeType, LinkType>* net_; ///< network the iterator belongs to
+		const TypedNetwork<NodeType, LinkType, _LinkStates>* net_; ///< network the iterator belongs to
 		node_id_t n_; ///< node ID the iterator is for
-		typename NodeType::LinkSet::iterator cur_; ///< current iterator position
+		typename NodeType::LinkIDIterator cur_; ///< current iterator position
 	}; // class TypedNetwork::NeighborIterator
 
 	typedef std::pair<NeighborIterator, NeighborIterator> NeighborIteratorRange; ///< Neighbor iterator range type.
@@ -147,8 +167,8 @@ public:
 			node_state_size_t nNodeStates, LinkStateCalculator* lsCalc = 0);
 
 	/**
-	 * Copy constructor.
-	 * @param net
+	 * Copy constructor. Nodes and links keep their IDs.
+	 * @param net Network to copy.
 	 */
 	TypedNetwork(const TypedNetwork& net);
 
@@ -168,6 +188,48 @@ public:
 	 */
 	NeighborLinkIteratorRange neighborLinks(node_id_t n) const;
 
+	/*
+	 * The following queries hide their counterparts in BasicNetwork, see
+	 * there for documentation. They call the implementation of this class
+	 * directly instead of going through a virtual function, so that they
+	 * can be inlined into loops that know the concrete network type, such as
+	 * the algorithms in measures.h or a model holding a reference to a
+	 * Network. Called through a BasicNetwork reference, the same
+	 * implementation is reached by virtual dispatch. Mutating methods are
+	 * still dispatched virtually, since derived classes such as
+	 * TripleMultiNetwork hook into them.
+	 */
+	id_size_t numberOfNodes() const;
+	id_size_t numberOfNodes(node_state_t s) const;
+	id_size_t numberOfNodes(state_group_t g) const;
+	id_size_t numberOfLinks() const;
+	id_size_t numberOfLinks(link_state_t s) const;
+	id_size_t numberOfLinks(state_group_t g) const;
+	node_state_size_t numberOfNodeStates() const;
+	link_state_size_t numberOfLinkStates() const;
+	std::pair<bool, link_id_t> isLink(node_id_t source, node_id_t target) const;
+	id_size_t neighborsInState(node_id_t n, node_state_t s) const;
+	id_size_t degree(node_id_t n) const;
+	node_state_t nodeState(node_id_t n) const;
+	link_state_t linkState(link_id_t l) const;
+	node_id_t source(link_id_t l) const;
+	node_id_t target(link_id_t l) const;
+	NodeIteratorRange nodes() const;
+	NodeStateIteratorRange nodes(node_state_t s) const;
+	LinkIteratorRange links() const;
+	LinkStateIteratorRange links(link_state_t s) const;
+	std::pair<bool, node_id_t> randomNode() const;
+	std::pair<bool, node_id_t> randomNode(node_state_t s) const;
+	std::pair<bool, node_id_t> randomNode(state_group_t g) const;
+	std::pair<bool, link_id_t> randomLink() const;
+	std::pair<bool, link_id_t> randomLink(link_state_t s) const;
+	std::pair<bool, link_id_t> randomLink(state_group_t g) const;
+	std::pair<bool, link_id_t> randomNeighborLink(node_id_t n) const;
+	std::pair<bool, node_id_t> randomNeighbor(node_id_t n) const;
+	std::pair<bool, link_id_t> randomNeighborLink(node_id_t n,
+			link_state_t s) const;
+	std::pair<bool, node_id_t> randomNeighbor(node_id_t n, node_state_t s) const;
+
 private:
 	/* FIXME boost::graph needs copy-constructible graph concepts
 	 *
@@ -179,12 +241,21 @@ protected:
 	node_id_t doAddNode();
 	node_id_t doAddNode(node_state_t s);
 	link_id_t doAddLink(node_id_t source, node_id_t target);
+	void doAddLinks(const EdgeList& edges);
+	/**
+	 * Insert links between the node pairs in @p edges as doAddLinks() does.
+	 * @param edges (source, target) pairs of node IDs.
+	 * @param[out] ids Receives the IDs of the new links, in the order of
+	 * @p edges.
+	 */
+	void insertLinks(const EdgeList& edges, std::vector<link_id_t>& ids);
 	bool
 	doChangeLink(link_id_t l, node_id_t source, node_id_t target);
 	void doRemoveLink(link_id_t l);
 	void doRemoveNode(node_id_t n);
 	void doRemoveAllLinks();
 	void doClear();
+	void doCompact(IDMap& map);
 	void doSetNodeState(node_id_t n, node_state_t s);
 
 	/**
@@ -210,6 +281,14 @@ protected:
 	 * @param n ID of node that changed its state
 	 */
 	virtual void onNodeStateChange(node_id_t n);
+	/**
+	 * Called at the end of a batch of node state changes (see
+	 * BasicNetwork::commitBatch()). Updates the states of all adjacent links
+	 * at once.
+	 * @param nodes IDs of nodes that changed their state, ascending and
+	 * unique.
+	 */
+	virtual void onNodeStatesChange(const std::vector<node_id_t>& nodes);
 
 	virtual void beforeRemoveLink(link_id_t l)
 	{
@@ -244,6 +323,19 @@ protected:
 	 * Recalculate states of all links.
 	 */
 	void recalcLinkStates();
+	/**
+	 * Recalculate states of the links in @p links.
+	 * @param links Unique link IDs.
+	 */
+	void recalcLinkStatesOf(const std::vector<link_id_t>& links);
+	/**
+	 * Collect the IDs of all links adjacent to the nodes in @p nodes, each
+	 * one once and in ascending order. Removed nodes are skipped.
+	 * @param nodes %Node IDs.
+	 * @param[out] links Receives the link IDs.
+	 */
+	void collectNeighborLinks(const std::vector<node_id_t>& nodes,
+			std::vector<link_id_t>& links) const;
 
 	void doReset(id_size_t nNodes, id_size_t nLinks,
 			node_state_size_t nNodeStates);
@@ -276,6 +368,10 @@ private:
 	 * @return Number of links in state @p s.
 	 */
 	id_size_t getNumberOfLinks(link_state_t s) const;
+	id_size_t getNumberOfNodes(state_group_t g) const;
+	id_size_t getNumberOfLinks(state_group_t g) const;
+	state_group_t doAddNodeStateGroup(const std::vector<node_state_t>& states);
+	state_group_t doAddLinkStateGroup(const std::vector<link_state_t>& states);
 	/**
 	 * Get number of possible node states.
 	 * @return Number of possible node states.
@@ -296,6 +392,11 @@ private:
 	 */
 	std::pair<bool, link_id_t>
 	doIsLink(node_id_t source, node_id_t target) const;
+	void doEnableEdgeIndex(bool enable);
+	bool getEdgeIndexEnabled() const;
+	id_size_t getNeighborsInState(node_id_t n, node_state_t s) const;
+	void doEnableNeighborStateCounts(bool enable);
+	bool getNeighborStateCountsEnabled() const;
 
 	/**
 	 * Degree of node @p n.
@@ -357,6 +458,19 @@ private:
 	 * @p s and the returned link ID is invalid.
 	 */
 	std::pair<bool, link_id_t> getRandomLink(link_state_t s) const;
+	std::pair<bool, node_id_t> getRandomNode(state_group_t g) const;
+	std::pair<bool, link_id_t> getRandomLink(state_group_t g) const;
+	std::pair<bool, node_id_t> getRandomNodeWeighted(node_state_t s) const;
+	std::pair<bool, link_id_t> getRandomLinkWeighted(link_state_t s) const;
+	std::pair<bool, node_id_t> getRandomNodeByDegree() const;
+	std::pair<bool, node_id_t> getRandomNodeByDegree(node_state_t s) const;
+
+	void doSetNodeWeight(node_id_t n, double w);
+	double getNodeWeight(node_id_t n) const;
+	void doSetLinkWeight(link_id_t l, double w);
+	double getLinkWeight(link_id_t l) const;
+	double getTotalNodeWeight(node_state_t s) const;
+	double getTotalLinkWeight(link_state_t s) const;
 
 	/**
 	 * Get random link adjacent to node @p n.
@@ -372,19 +486,191 @@ private:
 	 * the returned node ID is invalid.
 	 */
 	std::pair<bool, node_id_t> getRandomNeighbor(node_id_t n) const;
+	std::pair<bool, link_id_t> getRandomNeighborLink(node_id_t n,
+			link_state_t s) const;
+	std::pair<bool, node_id_t> getRandomNeighbor(node_id_t n, node_state_t s) const;
 
 	LinkIteratorRange getLinks() const;
 	LinkStateIteratorRange getLinks(link_state_t s) const;
 	NodeIteratorRange getNodes() const;
 	NodeStateIteratorRange getNodes(link_state_t s) const;
+	IDSpan getNodeIDs(node_state_t s) const;
+	IDSpan getLinkIDs(link_state_t s) const;
+
+private:
+	/**
+	 * Insert link @p l into the link list of its end node @p n.
+	 * @param n %Node ID
+	 * @param l %Link ID
+	 * @param atSource True if @p n is the source of @p l, false if it is the target.
+	 */
+	void attachLink(node_id_t n, link_id_t l, bool atSource);
+	void attachLink(node_id_t n, link_id_t l, bool atSource, set_adjacency_tag);
+	void attachLink(node_id_t n, link_id_t l, bool atSource, flat_adjacency_tag);
+	/**
+	 * Remove link @p l from the link list of its end node @p n.
+	 * @param n %Node ID
+	 * @param l %Link ID
+	 * @param atSource True if @p n is the source of @p l, false if it is the target.
+	 */
+	void detachLink(node_id_t n, link_id_t l, bool atSource);
+	void detachLink(node_id_t n, link_id_t l, bool atSource, set_adjacency_tag);
+	void detachLink(node_id_t n, link_id_t l, bool atSource, flat_adjacency_tag);
+	/**
+	 * Store the current opposite end of link @p l in the link list of its end
+	 * node @p n.
+	 * @param n %Node ID
+	 * @param l %Link ID
+	 * @param atSource True if @p n is the source of @p l, false if it is the target.
+	 */
+	void updateNeighbor(node_id_t n, link_id_t l, bool atSource);
+	void updateNeighbor(node_id_t n, link_id_t l, bool atSource, set_adjacency_tag);
+	void updateNeighbor(node_id_t n, link_id_t l, bool atSource, flat_adjacency_tag);
+	void attachLink(node_id_t n, link_id_t l, bool atSource, partitioned_adjacency_tag);
+	void detachLink(node_id_t n, link_id_t l, bool atSource, partitioned_adjacency_tag);
+	/**
+	 * Reserve room in the link lists of the end nodes of @p edges for these
+	 * links. Only needed for array-based adjacency.
+	 * @param edges (source, target) pairs about to be added.
+	 */
+	void reserveAdjacency(const EdgeList& edges, set_adjacency_tag);
+	template<class _Tag>
+	void reserveAdjacency(const EdgeList& edges, _Tag);
+	void updateNeighbor(node_id_t n, link_id_t l, bool atSource, partitioned_adjacency_tag);
+	/**
+	 * Move the entries for node @p n in its neighbors' link lists to the
+	 * groups for node state @p s. Only needed for PartitionedNode.
+	 * @param n %Node ID
+	 * @param s New state of @p n.
+	 */
+	template<class _Tag>
+	void regroupNeighbors(node_id_t n, node_state_t s, _Tag);
+	void regroupNeighbors(node_id_t n, node_state_t s, partitioned_adjacency_tag);
+	/**
+	 * Replace node and link IDs in the link list of @p theNode according to
+	 * @p map.
+	 * @param theNode %Node whose link list to change.
+	 * @param map ID maps as returned by compact().
+	 * @param temp Scratch space.
+	 */
+	template<class _Tag>
+	void remapLinkList(NodeType& theNode, const IDMap& map,
+			std::vector<Adjacency>& temp, _Tag);
+	void remapLinkList(NodeType& theNode, const IDMap& map,
+			std::vector<Adjacency>& temp, partitioned_adjacency_tag);
+	/**
+	 * Return group of the link list of a PartitionedNode a link belongs to.
+	 * @param neighborState State of the node at the other end of the link.
+	 * @param atSource True if the node owning the link list is the source of
+	 * the link, false if it is the target.
+	 */
+	static id_size_t adjacencyGroup(node_state_t neighborState, bool atSource);
+	/**
+	 * Observer for PartitionedNode link list changes, storing new slots in
+	 * the links.
+	 */
+	class SlotUpdater
+	{
+	public:
+		SlotUpdater(const TypedNetwork& net) :
+				net_(net)
+		{
+		}
+		void operator()(const link_id_t l, const id_size_t g,
+				const id_size_t slot)
+		{
+			net_.link(l).setSlot(g % 2 == 0, slot);
+		}
+	private:
+		const TypedNetwork& net_;
+	};
+
+	template<class _Tag>
+	id_size_t countNeighborsInState(node_id_t n, node_state_t s, _Tag) const;
+	id_size_t countNeighborsInState(node_id_t n, node_state_t s,
+			partitioned_adjacency_tag) const;
+	template<class _Tag>
+	std::pair<bool, link_id_t> randomNeighborLinkInState(node_id_t n,
+			link_state_t s, _Tag) const;
+	std::pair<bool, link_id_t> randomNeighborLinkInState(node_id_t n,
+			link_state_t s, partitioned_adjacency_tag) const;
+	template<class _Tag>
+	std::pair<bool, node_id_t> randomNeighborInState(node_id_t n,
+			node_state_t s, _Tag) const;
+	std::pair<bool, node_id_t> randomNeighborInState(node_id_t n,
+			node_state_t s, partitioned_adjacency_tag) const;
+
+	/**
+	 * Find a link between nodes @p a and @p b by scanning the link list of
+	 * the node with smaller degree.
+	 * @param a %Node ID
+	 * @param b %Node ID
+	 * @return Pair of bool and link ID, as in isLink().
+	 */
+	std::pair<bool, link_id_t> scanForLink(node_id_t a, node_id_t b) const;
+	/**
+	 * Find a link between nodes @p a and @p b by scanning the link list of @p a.
+	 * @param a %Node ID
+	 * @param b %Node ID
+	 * @return Pair of bool and link ID, as in isLink().
+	 */
+	std::pair<bool, link_id_t> scanLinkList(node_id_t a, node_id_t b) const;
+	/**
+	 * Fill edge index from scratch.
+	 */
+	void rebuildEdgeIndex();
+	/**
+	 * Fill table of link ends from scratch, creating it if necessary.
+	 */
+	void rebuildEndpointTable() const;
+	/**
+	 * Fill neighbor state counts from scratch, creating them if necessary.
+	 */
+	void rebuildNeighborStateCounts();
+	/**
+	 * Add or remove both ends of link @p l to or from the table of link ends
+	 * and the neighbor state counts, where these are in use.
+	 * @param l %Link ID
+	 * @param add True to add, false to remove the link.
+	 */
+	void updateLinkEnds(link_id_t l, bool add);
+	/**
+	 * Calculate link state from end node states using the link state
+	 * calculator.
+	 * @param source Source node's state.
+	 * @param target Target node's state.
+	 * @return %Link state.
+	 */
+	link_state_t calcLinkState(node_state_t source, node_state_t target) const;
+	/**
+	 * Create the node and link stores and install the link state calculator,
+	 * or a default one if @p lsCalc is 0.
+	 * @param nNodes Number of nodes to create.
+	 * @param nLinks Number of links to reserve space for.
+	 * @param nNodeStates Number of node states.
+	 * @param lsCalc Link state calculator to use, or 0.
+	 */
+	void setup(id_size_t nNodes, id_size_t nLinks,
+			node_state_size_t nNodeStates, LinkStateCalculator* lsCalc);
+	/**
+	 * Point calc_ to the current link state calculator.
+	 */
+	void bindLinkStateCalculator();
+	bool getLinkStateCalculatorSupported(const LinkStateCalculator& lc) const;
+	LinkStateCalculator* newDefaultLinkStateCalculator(
+			node_state_size_t nNodeStates) const;
 
 private:
 	NodeRepo* nodeStore_; ///< repository of nodes
 	LinkRepo* linkStore_; ///< repository of links
+	EdgeIndex* edgeIndex_; ///< optional index of links by end nodes, 0 if disabled
+	mutable EndpointTable* endpoints_; ///< link ends by node state, set up by the first call to randomNodeByDegree(s)
+	NeighborStateCounts* neighborCounts_; ///< optional neighbor state counts, 0 if disabled
+	const _LinkStates* calc_; ///< the link state calculator as its concrete type
 };
 
-template<class _Node, class _Link>
-inline std::string TypedNetwork<_Node, _Link>::getInfo() const
+template<class _Node, class _Link, class _LinkStates>
+inline std::string TypedNetwork<_Node, _Link, _LinkStates>::getInfo() const
 {
 	std::stringstream ss;
 	ss << "Network of N = " << numberOfNodes() << " nodes in "
@@ -396,185 +682,304 @@ inline std::string TypedNetwork<_Node, _Link>::getInfo() const
 	return ss.str();
 }
 
-template<class _Node, class _Link>
-inline typename TypedNetwork<_Node, _Link>::NodeRepo& TypedNetwork<_Node, _Link>::nodeStore() const
+template<class _Node, class _Link, class _LinkStates>
+inline typename TypedNetwork<_Node, _Link, _LinkStates>::NodeRepo& TypedNetwork<_Node, _Link, _LinkStates>::nodeStore() const
 {
 	return *nodeStore_;
 }
 
-template<class _Node, class _Link>
-inline typename TypedNetwork<_Node, _Link>::LinkRepo& TypedNetwork<_Node, _Link>::linkStore() const
+template<class _Node, class _Link, class _LinkStates>
+inline typename TypedNetwork<_Node, _Link, _LinkStates>::LinkRepo& TypedNetwork<_Node, _Link, _LinkStates>::linkStore() const
 {
 	return *linkStore_;
 }
 
-template<class _Node, class _Link>
-inline id_size_t TypedNetwork<_Node, _Link>::getNumberOfNodes() const
+template<class _Node, class _Link, class _LinkStates>
+inline id_size_t TypedNetwork<_Node, _Link, _LinkStates>::getNumberOfNodes() const
 {
 	return nodeStore_->size();
 }
 
-template<class _Node, class _Link>
-inline id_size_t TypedNetwork<_Node, _Link>::getNumberOfNodes(
+template<class _Node, class _Link, class _LinkStates>
+inline id_size_t TypedNetwork<_Node, _Link, _LinkStates>::getNumberOfNodes(
 		const node_state_t s) const
 {
 	return nodeStore_->count(s);
 }
 
-template<class _Node, class _Link>
-inline id_size_t TypedNetwork<_Node, _Link>::getNumberOfLinks() const
+template<class _Node, class _Link, class _LinkStates>
+inline id_size_t TypedNetwork<_Node, _Link, _LinkStates>::getNumberOfLinks() const
 {
 	return linkStore_->size();
 }
 
-template<class _Node, class _Link>
-inline id_size_t TypedNetwork<_Node, _Link>::getNumberOfLinks(
+template<class _Node, class _Link, class _LinkStates>
+inline id_size_t TypedNetwork<_Node, _Link, _LinkStates>::getNumberOfLinks(
 		const link_state_t s) const
 {
 	return linkStore_->count(s);
 }
 
-template<class _Node, class _Link>
-inline typename TypedNetwork<_Node, _Link>::NodeType& TypedNetwork<_Node, _Link>::node(
+template<class _Node, class _Link, class _LinkStates>
+inline id_size_t TypedNetwork<_Node, _Link, _LinkStates>::getNumberOfNodes(
+		const state_group_t g) const
+{
+	return nodeStore_->count(g);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline id_size_t TypedNetwork<_Node, _Link, _LinkStates>::getNumberOfLinks(
+		const state_group_t g) const
+{
+	return linkStore_->count(g);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline state_group_t TypedNetwork<_Node, _Link, _LinkStates>::doAddNodeStateGroup(
+		const std::vector<node_state_t>& states)
+{
+	return nodeStore_->addGroup(states.begin(), states.end());
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline state_group_t TypedNetwork<_Node, _Link, _LinkStates>::doAddLinkStateGroup(
+		const std::vector<link_state_t>& states)
+{
+	return linkStore_->addGroup(states.begin(), states.end());
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline void TypedNetwork<_Node, _Link, _LinkStates>::doSetNodeWeight(const node_id_t n,
+		const double w)
+{
+	assert(nodeStore_->valid(n));
+	nodeStore_->setWeight(n, w);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline double TypedNetwork<_Node, _Link, _LinkStates>::getNodeWeight(const node_id_t n) const
+{
+	return nodeStore_->weight(n);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline void TypedNetwork<_Node, _Link, _LinkStates>::doSetLinkWeight(const link_id_t l,
+		const double w)
+{
+	assert(linkStore_->valid(l));
+	linkStore_->setWeight(l, w);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline double TypedNetwork<_Node, _Link, _LinkStates>::getLinkWeight(const link_id_t l) const
+{
+	return linkStore_->weight(l);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline double TypedNetwork<_Node, _Link, _LinkStates>::getTotalNodeWeight(
+		const node_state_t s) const
+{
+	return nodeStore_->totalWeight(s);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline double TypedNetwork<_Node, _Link, _LinkStates>::getTotalLinkWeight(
+		const link_state_t s) const
+{
+	return linkStore_->totalWeight(s);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline typename TypedNetwork<_Node, _Link, _LinkStates>::NodeType& TypedNetwork<_Node, _Link, _LinkStates>::node(
 		const node_id_t n) const
 {
 	return (*nodeStore_)[n];
 }
 
-template<class _Node, class _Link>
-inline typename TypedNetwork<_Node, _Link>::LinkType& TypedNetwork<_Node, _Link>::link(
+template<class _Node, class _Link, class _LinkStates>
+inline typename TypedNetwork<_Node, _Link, _LinkStates>::LinkType& TypedNetwork<_Node, _Link, _LinkStates>::link(
 		const link_id_t l) const
 {
 	return (*linkStore_)[l];
 }
 
-template<class _Node, class _Link>
-inline node_id_t TypedNetwork<_Node, _Link>::getSource(const link_id_t l) const
+template<class _Node, class _Link, class _LinkStates>
+inline node_id_t TypedNetwork<_Node, _Link, _LinkStates>::getSource(const link_id_t l) const
 {
 	return link(l).source();
 }
 
-template<class _Node, class _Link>
-inline node_id_t TypedNetwork<_Node, _Link>::getTarget(const link_id_t l) const
+template<class _Node, class _Link, class _LinkStates>
+inline node_id_t TypedNetwork<_Node, _Link, _LinkStates>::getTarget(const link_id_t l) const
 {
 	return link(l).target();
 }
 
-template<class _Node, class _Link>
-inline BasicNetwork::NodeIteratorRange TypedNetwork<_Node, _Link>::getNodes() const
+template<class _Node, class _Link, class _LinkStates>
+inline BasicNetwork::NodeIteratorRange TypedNetwork<_Node, _Link, _LinkStates>::getNodes() const
 {
 	return nodeStore_->ids();
 }
 
-template<class _Node, class _Link>
-inline BasicNetwork::NodeStateIteratorRange TypedNetwork<_Node, _Link>::getNodes(
+template<class _Node, class _Link, class _LinkStates>
+inline BasicNetwork::NodeStateIteratorRange TypedNetwork<_Node, _Link, _LinkStates>::getNodes(
 		const node_state_t s) const
 {
 	return nodeStore_->ids(s);
 }
 
-template<class _Node, class _Link>
-inline BasicNetwork::LinkIteratorRange TypedNetwork<_Node, _Link>::getLinks() const
+template<class _Node, class _Link, class _LinkStates>
+inline BasicNetwork::LinkIteratorRange TypedNetwork<_Node, _Link, _LinkStates>::getLinks() const
 {
 	return linkStore_->ids();
 }
 
-template<class _Node, class _Link>
-inline BasicNetwork::LinkStateIteratorRange TypedNetwork<_Node, _Link>::getLinks(
+template<class _Node, class _Link, class _LinkStates>
+inline BasicNetwork::LinkStateIteratorRange TypedNetwork<_Node, _Link, _LinkStates>::getLinks(
 		const link_state_t s) const
 {
 	return linkStore_->ids(s);
 }
 
-template<class _Node, class _Link>
-inline id_size_t TypedNetwork<_Node, _Link>::getDegree(const node_id_t n) const
+template<class _Node, class _Link, class _LinkStates>
+inline BasicNetwork::IDSpan TypedNetwork<_Node, _Link, _LinkStates>::getNodeIDs(
+		const node_state_t s) const
+{
+	return nodeStore_->idSpan(s);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline BasicNetwork::IDSpan TypedNetwork<_Node, _Link, _LinkStates>::getLinkIDs(
+		const link_state_t s) const
+{
+	return linkStore_->idSpan(s);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline id_size_t TypedNetwork<_Node, _Link, _LinkStates>::getDegree(const node_id_t n) const
 {
 	return node(n).degree();
 }
 
-template<class _Node, class _Link>
-inline node_state_t TypedNetwork<_Node, _Link>::getNodeState(
+template<class _Node, class _Link, class _LinkStates>
+inline node_state_t TypedNetwork<_Node, _Link, _LinkStates>::getNodeState(
 		const node_id_t n) const
 {
 	return nodeStore_->category(n);
 }
 
-template<class _Node, class _Link>
-inline link_state_t TypedNetwork<_Node, _Link>::getLinkState(
+template<class _Node, class _Link, class _LinkStates>
+inline link_state_t TypedNetwork<_Node, _Link, _LinkStates>::getLinkState(
 		const link_id_t l) const
 {
 	return linkStore_->category(l);
 }
 
-template<class _Node, class _Link>
-inline node_state_size_t TypedNetwork<_Node, _Link>::getNumberOfNodeStates() const
+template<class _Node, class _Link, class _LinkStates>
+inline node_state_size_t TypedNetwork<_Node, _Link, _LinkStates>::getNumberOfNodeStates() const
 {
 	return nodeStore_->numberOfCategories();
 }
 
-template<class _Node, class _Link>
-inline link_state_size_t TypedNetwork<_Node, _Link>::getNumberOfLinkStates() const
+template<class _Node, class _Link, class _LinkStates>
+inline link_state_size_t TypedNetwork<_Node, _Link, _LinkStates>::getNumberOfLinkStates() const
 {
 	return linkStore_->numberOfCategories();
 }
 
-template<class _Node, class _Link>
-TypedNetwork<_Node, _Link>::TypedNetwork() :
-		BasicNetwork(), nodeStore_(new NodeRepo(1, 0)), linkStore_(
-				new LinkRepo(1, 0))
+template<class _Node, class _Link, class _LinkStates>
+TypedNetwork<_Node, _Link, _LinkStates>::TypedNetwork() :
+		BasicNetwork(), nodeStore_(0), linkStore_(0), edgeIndex_(0),
+				endpoints_(0), neighborCounts_(0), calc_(0)
 {
+	setup(0, 0, detail::DefaultLinkStates<_LinkStates>::numberOfNodeStates(1),
+			0);
 }
 
-template<class _Node, class _Link>
-TypedNetwork<_Node, _Link>::TypedNetwork(const TypedNetwork<_Node, _Link>& net) :
+template<class _Node, class _Link, class _LinkStates>
+TypedNetwork<_Node, _Link, _LinkStates>::TypedNetwork(const TypedNetwork<_Node, _Link, _LinkStates>& net) :
 		BasicNetwork(net), nodeStore_(new NodeRepo(*net.nodeStore_)), linkStore_(
-				new LinkRepo(*net.linkStore_))
+				new LinkRepo(*net.linkStore_)), edgeIndex_(
+				net.edgeIndex_ ? new EdgeIndex(*net.edgeIndex_) : 0), endpoints_(
+				net.endpoints_ ? new EndpointTable(*net.endpoints_) : 0),
+				neighborCounts_(
+						net.neighborCounts_ ? new NeighborStateCounts(
+								*net.neighborCounts_) : 0), calc_(0)
 {
+	bindLinkStateCalculator();
 }
 
-template<class _Node, class _Link>
-TypedNetwork<_Node, _Link>::TypedNetwork(const id_size_t nNodes,
+template<class _Node, class _Link, class _LinkStates>
+TypedNetwork<_Node, _Link, _LinkStates>::TypedNetwork(const id_size_t nNodes,
 		const id_size_t nLinks, const node_state_size_t nNodeStates,
 		LinkStateCalculator* lsCalc) :
-		BasicNetwork(lsCalc), nodeStore_(new NodeRepo(nNodeStates, nNodes)), linkStore_(
-				0)
+		BasicNetwork(lsCalc), nodeStore_(0), linkStore_(0), edgeIndex_(0),
+				endpoints_(0), neighborCounts_(0), calc_(0)
 {
-	// FIXME this is awkward, but fixes memory leak
+	setup(nNodes, nLinks, nNodeStates, lsCalc);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+void TypedNetwork<_Node, _Link, _LinkStates>::setup(const id_size_t nNodes,
+		const id_size_t nLinks, const node_state_size_t nNodeStates,
+		LinkStateCalculator* lsCalc)
+{
+	if ((lsCalc != 0) && !getLinkStateCalculatorSupported(*lsCalc))
+		throw(std::invalid_argument(
+				"LinkStateCalculator is not of the type the network requires!"));
+	link_state_size_t nLinkStates = 0;
 	if (lsCalc == 0)
 	{
-		DefaultLinkStateCalculator dlsc(nNodeStates);
-		linkStore_ = new LinkRepo(dlsc.numberOfLinkStates(), nLinks);
-		setLinkStateCalculator(0);
+		const LinkStateCalculator* dlsc = newDefaultLinkStateCalculator(
+				nNodeStates);
+		nLinkStates = dlsc->numberOfLinkStates();
+		delete dlsc;
 	}
 	else
-	{
-		linkStore_ = new LinkRepo(linkStateCalculator().numberOfLinkStates(),
-				nLinks);
-	}
+		nLinkStates = lsCalc->numberOfLinkStates();
+	nodeStore_ = new NodeRepo(nNodeStates, nNodes);
+	linkStore_ = new LinkRepo(nLinkStates, nLinks);
+	// FIXME this is awkward, but fixes memory leak
+	if (lsCalc == 0)
+		setLinkStateCalculator(0);
+	else
+		bindLinkStateCalculator();
 	init(nNodes);
 }
 
-template<class _Node, class _Link>
-TypedNetwork<_Node, _Link>::~TypedNetwork()
+template<class _Node, class _Link, class _LinkStates>
+TypedNetwork<_Node, _Link, _LinkStates>::~TypedNetwork()
 {
 	delete nodeStore_;
 	delete linkStore_;
+	delete edgeIndex_;
+	delete endpoints_;
+	delete neighborCounts_;
 }
 
-template<class _Node, class _Link>
-void TypedNetwork<_Node, _Link>::doReset(const id_size_t nNodes,
+template<class _Node, class _Link, class _LinkStates>
+void TypedNetwork<_Node, _Link, _LinkStates>::doReset(const id_size_t nNodes,
 		const id_size_t nLinks, const node_state_size_t nNodeStates)
 {
 	delete nodeStore_;
 	delete linkStore_;
+	bindLinkStateCalculator();
 	nodeStore_ = new NodeRepo(nNodeStates, nNodes);
 	linkStore_ = new LinkRepo(linkStateCalculator().numberOfLinkStates(),
 			nLinks);
+	if (edgeIndex_)
+		edgeIndex_->clear();
+	// the number of node states may have changed
+	delete endpoints_;
+	endpoints_ = 0;
 	init(nNodes);
+	if (neighborCounts_)
+		rebuildNeighborStateCounts();
 }
 
-template<class _Node, class _Link>
-void TypedNetwork<_Node, _Link>::init(id_size_t nodes)
+template<class _Node, class _Link, class _LinkStates>
+void TypedNetwork<_Node, _Link, _LinkStates>::init(id_size_t nodes)
 {
 	for (id_size_t i = 0; i < nodes; ++i)
 	{
@@ -582,143 +987,395 @@ void TypedNetwork<_Node, _Link>::init(id_size_t nodes)
 	}
 }
 
-template<class _Node, class _Link>
-void TypedNetwork<_Node, _Link>::doRemoveLink(const link_id_t l)
+template<class _Node, class _Link, class _LinkStates>
+void TypedNetwork<_Node, _Link, _LinkStates>::doRemoveLink(const link_id_t l)
 {
 	LinkType& theLink = link(l);
-	node(theLink.source()).removeLink(l);
-	node(theLink.target()).removeLink(l);
+	detachLink(theLink.source(), l, true);
+	detachLink(theLink.target(), l, false);
+	updateLinkEnds(l, false);
+	if (edgeIndex_ && edgeIndex_->erase(theLink.source(), theLink.target(), l))
+		edgeIndex_->setLink(theLink.source(), theLink.target(),
+				scanForLink(theLink.source(), theLink.target()).second);
 	linkStore_->remove(l);
 }
 
-template<class _Node, class _Link>
-void TypedNetwork<_Node, _Link>::doRemoveAllLinks()
+template<class _Node, class _Link, class _LinkStates>
+void TypedNetwork<_Node, _Link, _LinkStates>::doRemoveAllLinks()
 {
 	NodeIteratorRange iters = nodes();
 	for (NodeIterator& it = iters.first; it != iters.second; ++it)
 	{
 		node(*it).clear();
 	}
+	if (edgeIndex_)
+		edgeIndex_->clear();
+	if (endpoints_)
+		endpoints_->clear();
+	if (neighborCounts_)
+		neighborCounts_->clear();
 	linkStore_->removeAll();
 }
 
-template<class _Node, class _Link>
-void TypedNetwork<_Node, _Link>::doRemoveNode(const node_id_t n)
+template<class _Node, class _Link, class _LinkStates>
+void TypedNetwork<_Node, _Link, _LinkStates>::doRemoveNode(const node_id_t n)
 {
 	typename NodeType::LinkIDIteratorRange iters = node(n).links();
 	for (typename NodeType::LinkIDIterator& li = iters.first;
 			li != iters.second; ++li)
 	{
-		// remove neighbors' references to connecting links
-		LinkType& l = link(*li);
-		node_id_t m = (l.source() == n) ? l.target() : l.source();
-		node(m).removeLink(*li);
+		// a self-loop appears twice in the link list
+		if (!linkStore_->valid(*li))
+			continue;
+		// remove neighbors' references to connecting links; the link list
+		// of n itself is left untouched while we iterate over it
+		const LinkType& l = link(*li);
+		if (!l.isLoop())
+		{
+			const node_id_t m = (l.source() == n) ? l.target() : l.source();
+			detachLink(m, *li, m == l.source());
+			// m's link list is up to date, so look for remaining n-m links there
+			if (edgeIndex_ && edgeIndex_->erase(n, m, *li))
+				edgeIndex_->setLink(n, m, scanLinkList(m, n).second);
+		}
+		else if (edgeIndex_)
+		{
+			// all other loops at n are removed, too
+			edgeIndex_->erase(n, n, *li);
+		}
+		updateLinkEnds(*li, false);
 		// delete connecting links
 		linkStore_->remove(*li);
 	}
 	nodeStore_->remove(n);
 }
 
-template<class _Node, class _Link>
-void TypedNetwork<_Node, _Link>::doClear()
+template<class _Node, class _Link, class _LinkStates>
+void TypedNetwork<_Node, _Link, _LinkStates>::doClear()
 {
 	removeAllLinks();
 	nodeStore_->removeAll();
 }
 
-template<class _Node, class _Link>
-node_id_t TypedNetwork<_Node, _Link>::doAddNode()
+template<class _Node, class _Link, class _LinkStates>
+void TypedNetwork<_Node, _Link, _LinkStates>::doCompact(IDMap& map)
+{
+	map.nodes = nodeStore_->compact();
+	map.links = linkStore_->compact();
+	std::vector<Adjacency> temp;
+	NodeIteratorRange nodeIters = nodes();
+	for (NodeIterator& it = nodeIters.first; it != nodeIters.second; ++it)
+		remapLinkList(node(*it), map, temp,
+				typename NodeType::adjacency_category());
+	LinkIteratorRange linkIters = links();
+	for (LinkIterator& it = linkIters.first; it != linkIters.second; ++it)
+	{
+		LinkType& theLink = link(*it);
+		theLink.setSource(map.nodes[theLink.source()]);
+		theLink.setTarget(map.nodes[theLink.target()]);
+	}
+	if (edgeIndex_)
+		rebuildEdgeIndex();
+	if (endpoints_)
+		rebuildEndpointTable();
+	if (neighborCounts_)
+		rebuildNeighborStateCounts();
+}
+
+template<class _Node, class _Link, class _LinkStates>
+node_id_t TypedNetwork<_Node, _Link, _LinkStates>::doAddNode()
 {
 	return doAddNode(0);
 }
 
-template<class _Node, class _Link>
-node_id_t TypedNetwork<_Node, _Link>::doAddNode(const node_state_t s)
+template<class _Node, class _Link, class _LinkStates>
+node_id_t TypedNetwork<_Node, _Link, _LinkStates>::doAddNode(const node_state_t s)
 {
-	return nodeStore_->insert(NodeType(), s);
+#if __cplusplus >= 201103L
+	const node_id_t n = nodeStore_->emplace(s);
+#else
+	const node_id_t n = nodeStore_->insert(NodeType(), s);
+#endif
+	if (neighborCounts_)
+		neighborCounts_->clear(n);
+	return n;
 }
 
-template<class _Node, class _Link>
-void TypedNetwork<_Node, _Link>::doSetNodeState(const node_id_t n,
+template<class _Node, class _Link, class _LinkStates>
+void TypedNetwork<_Node, _Link, _LinkStates>::doSetNodeState(const node_id_t n,
 		const node_state_t s)
 {
+	const node_state_t old = nodeState(n);
+	if ((endpoints_ || neighborCounts_) && (old != s))
+	{
+		typename NodeType::LinkIDIteratorRange iters = node(n).links();
+		for (typename NodeType::LinkIDIterator& it = iters.first;
+				it != iters.second; ++it)
+		{
+			if (neighborCounts_)
+				neighborCounts_->move(it.neighbor(), old, s);
+			if (endpoints_)
+			{
+				// both ends of a self-loop are moved at its first occurrence
+				const LinkType& theLink = link(*it);
+				if (theLink.source() == n)
+					endpoints_->move(*it, true, old, s);
+				if (theLink.target() == n)
+					endpoints_->move(*it, false, old, s);
+			}
+		}
+	}
+	if (old != s)
+		regroupNeighbors(n, s, typename NodeType::adjacency_category());
 	nodeStore_->setCategory(n, s);
 }
 
-template<class _Node, class _Link>
-void TypedNetwork<_Node, _Link>::onNodeStateChange(const node_id_t n)
+template<class _Node, class _Link, class _LinkStates>
+void TypedNetwork<_Node, _Link, _LinkStates>::onNodeStateChange(const node_id_t n)
 {
 	recalcLinkStates(n);
 }
 
-template<class _Node, class _Link>
-void TypedNetwork<_Node, _Link>::recalcLinkStates(const node_id_t n)
+template<class _Node, class _Link, class _LinkStates>
+void TypedNetwork<_Node, _Link, _LinkStates>::onNodeStatesChange(
+		const std::vector<node_id_t>& nodes)
+{
+	std::vector<link_id_t> links;
+	collectNeighborLinks(nodes, links);
+	recalcLinkStatesOf(links);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+void TypedNetwork<_Node, _Link, _LinkStates>::collectNeighborLinks(
+		const std::vector<node_id_t>& nodes,
+		std::vector<link_id_t>& links) const
+{
+	links.clear();
+	for (std::vector<node_id_t>::const_iterator n = nodes.begin();
+			n != nodes.end(); ++n)
+	{
+		if (!nodeStore_->valid(*n))
+			continue;
+		NeighborLinkIteratorRange iters = neighborLinks(*n);
+		links.insert(links.end(), iters.first, iters.second);
+	}
+	// links between two of the nodes appear twice
+	std::sort(links.begin(), links.end());
+	links.erase(std::unique(links.begin(), links.end()), links.end());
+}
+
+template<class _Node, class _Link, class _LinkStates>
+void TypedNetwork<_Node, _Link, _LinkStates>::recalcLinkStatesOf(
+		const std::vector<link_id_t>& links)
+{
+	std::vector<link_state_t> states;
+	states.reserve(links.size());
+	for (std::vector<link_id_t>::const_iterator it = links.begin();
+			it != links.end(); ++it)
+	{
+		states.push_back(
+				calcLinkState(nodeState(source(*it)), nodeState(target(*it))));
+	}
+	linkStore_->setCategories(links.begin(), links.end(), states.begin());
+}
+
+template<class _Node, class _Link, class _LinkStates>
+void TypedNetwork<_Node, _Link, _LinkStates>::recalcLinkStates(const node_id_t n)
 {
 	NeighborLinkIteratorRange iters = neighborLinks(n);
 	for (NeighborLinkIterator& it = iters.first; it != iters.second; ++it)
 	{
 		linkStore_->setCategory(*it,
-				linkStateCalculator()(getNodeState(source(*it)),
-						getNodeState(target(*it))));
+				calcLinkState(nodeState(source(*it)), nodeState(target(*it))));
 	}
 }
 
-template<class _Node, class _Link>
-void TypedNetwork<_Node, _Link>::recalcLinkStates()
+template<class _Node, class _Link, class _LinkStates>
+void TypedNetwork<_Node, _Link, _LinkStates>::recalcLinkStates()
 {
+	bindLinkStateCalculator();
+	std::vector<link_id_t> ids;
+	std::vector<link_state_t> states;
+	ids.reserve(numberOfLinks());
+	states.reserve(numberOfLinks());
 	LinkIteratorRange iters = links();
 	for (LinkIterator& it = iters.first; it != iters.second; ++it)
 	{
-		linkStore_->setCategory(*it,
-				linkStateCalculator()(getNodeState(source(*it)),
-						getNodeState(target(*it))));
+		ids.push_back(*it);
+		states.push_back(
+				calcLinkState(nodeState(source(*it)), nodeState(target(*it))));
 	}
+	linkStore_->setCategories(ids.begin(), ids.end(), states.begin());
 }
 
-template<class _Node, class _Link>
-std::pair<bool, link_id_t> TypedNetwork<_Node, _Link>::doIsLink(
+template<class _Node, class _Link, class _LinkStates>
+std::pair<bool, link_id_t> TypedNetwork<_Node, _Link, _LinkStates>::doIsLink(
 		const node_id_t source, const node_id_t target) const
 {
-	node_id_t a, b;
-	if (node(source).degree() < node(target).degree())
+	if (edgeIndex_)
+		return edgeIndex_->find(source, target);
+	return scanForLink(source, target);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline std::pair<bool, link_id_t> TypedNetwork<_Node, _Link, _LinkStates>::scanForLink(
+		const node_id_t a, const node_id_t b) const
+{
+	if (node(a).degree() < node(b).degree())
+		return scanLinkList(a, b);
+	else
+		return scanLinkList(b, a);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+std::pair<bool, link_id_t> TypedNetwork<_Node, _Link, _LinkStates>::scanLinkList(
+		const node_id_t a, const node_id_t b) const
+{
+	typename NodeType::LinkIDIteratorRange iters = node(a).links();
+	for (typename NodeType::LinkIDIterator& it = iters.first;
+			it != iters.second; ++it)
 	{
-		a = source;
-		b = target;
+		if (it.neighbor() == b)
+			return std::make_pair(true, *it);
 	}
-	else
+	return std::make_pair(false, 0);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+void TypedNetwork<_Node, _Link, _LinkStates>::doEnableEdgeIndex(const bool enable)
+{
+	if (enable && !edgeIndex_)
+	{
+		edgeIndex_ = new EdgeIndex;
+		rebuildEdgeIndex();
+	}
+	else if (!enable)
 	{
-		a = target;
-		b = source;
+		delete edgeIndex_;
+		edgeIndex_ = 0;
 	}
+}
 
-	typename NodeType::LinkIDIteratorRange iters = node(a).links();
-	if (a == b)
+template<class _Node, class _Link, class _LinkStates>
+inline bool TypedNetwork<_Node, _Link, _LinkStates>::getEdgeIndexEnabled() const
+{
+	return edgeIndex_ != 0;
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline id_size_t TypedNetwork<_Node, _Link, _LinkStates>::getNeighborsInState(
+		const node_id_t n, const node_state_t s) const
+{
+	if (neighborCounts_)
+		return neighborCounts_->count(n, s);
+	return countNeighborsInState(n, s, typename NodeType::adjacency_category());
+}
+
+template<class _Node, class _Link, class _LinkStates>
+void TypedNetwork<_Node, _Link, _LinkStates>::doEnableNeighborStateCounts(
+		const bool enable)
+{
+	if (enable && !neighborCounts_)
+		rebuildNeighborStateCounts();
+	else if (!enable)
 	{
-		for (typename NodeType::LinkIDIterator& it = iters.first;
-				it != iters.second; ++it)
+		delete neighborCounts_;
+		neighborCounts_ = 0;
+	}
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline bool TypedNetwork<_Node, _Link, _LinkStates>::getNeighborStateCountsEnabled() const
+{
+	return neighborCounts_ != 0;
+}
+
+template<class _Node, class _Link, class _LinkStates>
+void TypedNetwork<_Node, _Link, _LinkStates>::rebuildEdgeIndex()
+{
+	assert(edgeIndex_ != 0);
+	edgeIndex_->clear();
+	edgeIndex_->reserve(numberOfLinks());
+	LinkIteratorRange iters = links();
+	for (LinkIterator& it = iters.first; it != iters.second; ++it)
+	{
+		const LinkType& theLink = link(*it);
+		edgeIndex_->insert(theLink.source(), theLink.target(), *it);
+	}
+}
+
+template<class _Node, class _Link, class _LinkStates>
+void TypedNetwork<_Node, _Link, _LinkStates>::rebuildEndpointTable() const
+{
+	delete endpoints_;
+	endpoints_ = new EndpointTable(numberOfNodeStates());
+	LinkIteratorRange iters = links();
+	for (LinkIterator& it = iters.first; it != iters.second; ++it)
+	{
+		const LinkType& theLink = link(*it);
+		endpoints_->insert(*it, true, nodeState(theLink.source()));
+		endpoints_->insert(*it, false, nodeState(theLink.target()));
+	}
+}
+
+template<class _Node, class _Link, class _LinkStates>
+void TypedNetwork<_Node, _Link, _LinkStates>::rebuildNeighborStateCounts()
+{
+	delete neighborCounts_;
+	neighborCounts_ = new NeighborStateCounts(numberOfNodeStates());
+	NodeIteratorRange nodeIters = nodes();
+	for (NodeIterator& it = nodeIters.first; it != nodeIters.second; ++it)
+		neighborCounts_->clear(*it);
+	LinkIteratorRange linkIters = links();
+	for (LinkIterator& it = linkIters.first; it != linkIters.second; ++it)
+	{
+		const LinkType& theLink = link(*it);
+		neighborCounts_->increment(theLink.source(),
+				getNodeState(theLink.target()));
+		neighborCounts_->increment(theLink.target(),
+				getNodeState(theLink.source()));
+	}
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline void TypedNetwork<_Node, _Link, _LinkStates>::updateLinkEnds(const link_id_t l,
+		const bool add)
+{
+	if (!endpoints_ && !neighborCounts_)
+		return;
+	const LinkType& theLink = link(l);
+	const node_id_t a = theLink.source(), b = theLink.target();
+	const node_state_t s = nodeState(a), t = nodeState(b);
+	if (add)
+	{
+		if (endpoints_)
 		{
-			if (link(*it).isLoop())
-			{
-				return std::make_pair(true, *it);
-			}
+			endpoints_->insert(l, true, s);
+			endpoints_->insert(l, false, t);
+		}
+		if (neighborCounts_)
+		{
+			neighborCounts_->increment(a, t);
+			neighborCounts_->increment(b, s);
 		}
 	}
 	else
 	{
-		for (typename NodeType::LinkIDIterator& it = iters.first;
-				it != iters.second; ++it)
+		if (endpoints_)
 		{
-			if (link(*it).connectsTo(b))
-			{
-				return std::make_pair(true, *it);
-			}
+			endpoints_->erase(l, true, s);
+			endpoints_->erase(l, false, t);
+		}
+		if (neighborCounts_)
+		{
+			neighborCounts_->decrement(a, t);
+			neighborCounts_->decrement(b, s);
 		}
 	}
-	return std::make_pair(false, 0);
 }
 
-template<class _Node, class _Link>
-std::pair<bool, node_id_t> TypedNetwork<_Node, _Link>::getRandomNode() const
+template<class _Node, class _Link, class _LinkStates>
+std::pair<bool, node_id_t> TypedNetwork<_Node, _Link, _LinkStates>::getRandomNode() const
 {
 	std::pair<bool, node_id_t> ret = std::make_pair(false, 0);
 	if (nodeStore_->size() > 0)
@@ -731,8 +1388,8 @@ std::pair<bool, node_id_t> TypedNetwork<_Node, _Link>::getRandomNode() const
 	return ret;
 }
 
-template<class _Node, class _Link>
-std::pair<bool, node_id_t> TypedNetwork<_Node, _Link>::getRandomNode(
+template<class _Node, class _Link, class _LinkStates>
+std::pair<bool, node_id_t> TypedNetwork<_Node, _Link, _LinkStates>::getRandomNode(
 		const node_state_t s) const
 {
 	std::pair<bool, node_id_t> ret = std::make_pair(false, 0);
@@ -746,8 +1403,8 @@ std::pair<bool, node_id_t> TypedNetwork<_Node, _Link>::getRandomNode(
 	return ret;
 }
 
-template<class _Node, class _Link>
-std::pair<bool, link_id_t> TypedNetwork<_Node, _Link>::getRandomLink() const
+template<class _Node, class _Link, class _LinkStates>
+std::pair<bool, link_id_t> TypedNetwork<_Node, _Link, _LinkStates>::getRandomLink() const
 {
 	std::pair<bool, link_id_t> ret = std::make_pair(false, 0);
 	if (linkStore_->size() > 0)
@@ -760,8 +1417,8 @@ std::pair<bool, link_id_t> TypedNetwork<_Node, _Link>::getRandomLink() const
 	return ret;
 }
 
-template<class _Node, class _Link>
-std::pair<bool, link_id_t> TypedNetwork<_Node, _Link>::getRandomLink(
+template<class _Node, class _Link, class _LinkStates>
+std::pair<bool, link_id_t> TypedNetwork<_Node, _Link, _LinkStates>::getRandomLink(
 		const link_state_t s) const
 {
 	std::pair<bool, link_id_t> ret = std::make_pair(false, 0);
@@ -775,119 +1432,849 @@ std::pair<bool, link_id_t> TypedNetwork<_Node, _Link>::getRandomLink(
 	return ret;
 }
 
-template<class _Node, class _Link>
-std::pair<bool, link_id_t> TypedNetwork<_Node, _Link>::getRandomNeighborLink(
-		const node_id_t n) const
+template<class _Node, class _Link, class _LinkStates>
+std::pair<bool, node_id_t> TypedNetwork<_Node, _Link, _LinkStates>::getRandomNode(
+		const state_group_t g) const
 {
-	std::pair<bool, link_id_t> ret = std::make_pair(false, 0);
-	if (degree(n) != 0)
+	std::pair<bool, node_id_t> ret = std::make_pair(false, 0);
+	if (nodeStore_->count(g) > 0)
 	{
-		const id_size_t num = rng.IntFromTo<id_size_t>(0, degree(n) - 1);
-		NeighborLinkIteratorRange iters = neighborLinks(n);
-		NeighborLinkIterator it = iters.first;
-		std::advance(it, num);
-		ret.first = it != iters.second; // should always give true
-		ret.second = *it;
+		ret.first = true;
+		ret.second = nodeStore_->id(g,
+				static_cast<repo::address_t>(rng.IntFromTo<repo::id_size_t>(0,
+						nodeStore_->count(g) - 1)));
 	}
 	return ret;
 }
 
-template<class _Node, class _Link>
-std::pair<bool, node_id_t> TypedNetwork<_Node, _Link>::getRandomNeighbor(
-		const node_id_t n) const
+template<class _Node, class _Link, class _LinkStates>
+std::pair<bool, link_id_t> TypedNetwork<_Node, _Link, _LinkStates>::getRandomLink(
+		const state_group_t g) const
 {
-	std::pair<bool, node_id_t> ret = std::make_pair(false, 0);
-	if (degree(n) != 0)
+	std::pair<bool, link_id_t> ret = std::make_pair(false, 0);
+	if (linkStore_->count(g) > 0)
 	{
-		const id_size_t num = rng.IntFromTo<id_size_t>(0, degree(n) - 1);
-		NeighborIteratorRange iters = neighbors(n);
-		NeighborIterator it = iters.first;
-		std::advance(it, num);
-		ret.first = it != iters.second; // should always give true
-		ret.second = *it;
+		ret.first = true;
+		ret.second = linkStore_->id(g,
+				static_cast<repo::address_t>(rng.IntFromTo<repo::id_size_t>(0,
+						linkStore_->count(g) - 1)));
 	}
 	return ret;
 }
 
-template<class _Node, class _Link>
-typename TypedNetwork<_Node, _Link>::NeighborIteratorRange TypedNetwork<_Node,
-		_Link>::neighbors(const node_id_t n) const
+template<class _Node, class _Link, class _LinkStates>
+std::pair<bool, node_id_t> TypedNetwork<_Node, _Link, _LinkStates>::getRandomNodeWeighted(
+		const node_state_t s) const
 {
-	return std::make_pair(NeighborIterator(*this, n, node(n).links().first),
-			NeighborIterator(*this, n, node(n).links().second));
+	std::pair<bool, node_id_t> ret = std::make_pair(false, 0);
+	const double total = nodeStore_->totalWeight(s);
+	if ((nodeStore_->count(s) > 0) && (total > 0))
+	{
+		ret.first = true;
+		ret.second = nodeStore_->idByWeight(s, rng.Uniform01() * total);
+	}
+	return ret;
 }
 
-template<class _Node, class _Link>
-typename TypedNetwork<_Node, _Link>::NeighborLinkIteratorRange TypedNetwork<
-		_Node, _Link>::neighborLinks(const node_id_t n) const
+template<class _Node, class _Link, class _LinkStates>
+std::pair<bool, link_id_t> TypedNetwork<_Node, _Link, _LinkStates>::getRandomLinkWeighted(
+		const link_state_t s) const
 {
-	return node(n).links();
+	std::pair<bool, link_id_t> ret = std::make_pair(false, 0);
+	const double total = linkStore_->totalWeight(s);
+	if ((linkStore_->count(s) > 0) && (total > 0))
+	{
+		ret.first = true;
+		ret.second = linkStore_->idByWeight(s, rng.Uniform01() * total);
+	}
+	return ret;
 }
 
-template<class _Node, class _Link>
-link_id_t TypedNetwork<_Node, _Link>::doAddLink(const node_id_t source,
-		const node_id_t target)
+template<class _Node, class _Link, class _LinkStates>
+std::pair<bool, node_id_t> TypedNetwork<_Node, _Link, _LinkStates>::getRandomNodeByDegree() const
 {
-	const link_state_t s = linkStateCalculator()(getNodeState(source),
-			getNodeState(target));
-	const link_id_t l = linkStore_->insert(LinkType(source, target), s);
-	node(source).addLink(l);
-	node(target).addLink(l);
-	return l;
+	// every link end is equally likely
+	std::pair<bool, node_id_t> ret = std::make_pair(false, 0);
+	const std::pair<bool, link_id_t> l = getRandomLink();
+	if (l.first)
+	{
+		ret.first = true;
+		ret.second = rng.Chance(0.5) ? source(l.second) : target(l.second);
+	}
+	return ret;
 }
 
-template<class _Node, class _Link>
-bool TypedNetwork<_Node, _Link>::doChangeLink(const link_id_t l,
-		const node_id_t source, const node_id_t target)
+template<class _Node, class _Link, class _LinkStates>
+std::pair<bool, node_id_t> TypedNetwork<_Node, _Link, _LinkStates>::getRandomNodeByDegree(
+		const node_state_t s) const
+{
+	if (!endpoints_)
+		rebuildEndpointTable();
+	std::pair<bool, node_id_t> ret = std::make_pair(false, 0);
+	if (endpoints_->count(s) > 0)
+	{
+		const EndpointTable::Stub stub = endpoints_->stub(s,
+				rng.IntFromTo<id_size_t>(0, endpoints_->count(s) - 1));
+		ret.first = true;
+		ret.second = stub.second ? source(stub.first) : target(stub.first);
+	}
+	return ret;
+}
+
+template<class _Node, class _Link, class _LinkStates>
+std::pair<bool, link_id_t> TypedNetwork<_Node, _Link, _LinkStates>::getRandomNeighborLink(
+		const node_id_t n) const
+{
+	std::pair<bool, link_id_t> ret = std::make_pair(false, 0);
+	if (degree(n) != 0)
+	{
+		const id_size_t num = rng.IntFromTo<id_size_t>(0, degree(n) - 1);
+		NeighborLinkIteratorRange iters = neighborLinks(n);
+		NeighborLinkIterator it = iters.first;
+		std::advance(it, num);
+		ret.first = it != iters.second; // should always give true
+		ret.second = *it;
+	}
+	return ret;
+}
+
+template<class _Node, class _Link, class _LinkStates>
+std::pair<bool, node_id_t> TypedNetwork<_Node, _Link, _LinkStates>::getRandomNeighbor(
+		const node_id_t n) const
+{
+	std::pair<bool, node_id_t> ret = std::make_pair(false, 0);
+	if (degree(n) != 0)
+	{
+		const id_size_t num = rng.IntFromTo<id_size_t>(0, degree(n) - 1);
+		NeighborLinkIteratorRange iters = neighborLinks(n);
+		NeighborLinkIterator it = iters.first;
+		std::advance(it, num);
+		ret.first = it != iters.second; // should always give true
+		ret.second = it.neighbor();
+	}
+	return ret;
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline std::pair<bool, link_id_t> TypedNetwork<_Node, _Link, _LinkStates>::getRandomNeighborLink(
+		const node_id_t n, const link_state_t s) const
+{
+	return randomNeighborLinkInState(n, s,
+			typename NodeType::adjacency_category());
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline std::pair<bool, node_id_t> TypedNetwork<_Node, _Link, _LinkStates>::getRandomNeighbor(
+		const node_id_t n, const node_state_t s) const
+{
+	return randomNeighborInState(n, s, typename NodeType::adjacency_category());
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline id_size_t TypedNetwork<_Node, _Link, _LinkStates>::numberOfNodes() const
+{
+	return TypedNetwork::getNumberOfNodes();
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline id_size_t TypedNetwork<_Node, _Link, _LinkStates>::numberOfNodes(
+		const node_state_t s) const
+{
+	return TypedNetwork::getNumberOfNodes(s);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline id_size_t TypedNetwork<_Node, _Link, _LinkStates>::numberOfNodes(
+		const state_group_t g) const
+{
+	return TypedNetwork::getNumberOfNodes(g);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline id_size_t TypedNetwork<_Node, _Link, _LinkStates>::numberOfLinks() const
+{
+	return TypedNetwork::getNumberOfLinks();
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline id_size_t TypedNetwork<_Node, _Link, _LinkStates>::numberOfLinks(
+		const link_state_t s) const
+{
+	return TypedNetwork::getNumberOfLinks(s);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline id_size_t TypedNetwork<_Node, _Link, _LinkStates>::numberOfLinks(
+		const state_group_t g) const
+{
+	return TypedNetwork::getNumberOfLinks(g);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline node_state_size_t TypedNetwork<_Node, _Link, _LinkStates>::numberOfNodeStates() const
+{
+	return TypedNetwork::getNumberOfNodeStates();
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline link_state_size_t TypedNetwork<_Node, _Link, _LinkStates>::numberOfLinkStates() const
+{
+	return TypedNetwork::getNumberOfLinkStates();
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline std::pair<bool, link_id_t> TypedNetwork<_Node, _Link, _LinkStates>::isLink(
+		const node_id_t source, const node_id_t target) const
+{
+	return TypedNetwork::doIsLink(source, target);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline id_size_t TypedNetwork<_Node, _Link, _LinkStates>::neighborsInState(
+		const node_id_t n, const node_state_t s) const
+{
+	return TypedNetwork::getNeighborsInState(n, s);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline id_size_t TypedNetwork<_Node, _Link, _LinkStates>::degree(const node_id_t n) const
+{
+	return TypedNetwork::getDegree(n);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline node_state_t TypedNetwork<_Node, _Link, _LinkStates>::nodeState(
+		const node_id_t n) const
+{
+	return TypedNetwork::getNodeState(n);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline link_state_t TypedNetwork<_Node, _Link, _LinkStates>::linkState(
+		const link_id_t l) const
+{
+	return TypedNetwork::getLinkState(l);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline node_id_t TypedNetwork<_Node, _Link, _LinkStates>::source(const link_id_t l) const
+{
+	return TypedNetwork::getSource(l);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline node_id_t TypedNetwork<_Node, _Link, _LinkStates>::target(const link_id_t l) const
+{
+	return TypedNetwork::getTarget(l);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline typename TypedNetwork<_Node, _Link, _LinkStates>::NodeIteratorRange TypedNetwork<_Node,
+		_Link, _LinkStates>::nodes() const
+{
+	return TypedNetwork::getNodes();
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline typename TypedNetwork<_Node, _Link, _LinkStates>::NodeStateIteratorRange TypedNetwork<_Node,
+		_Link, _LinkStates>::nodes(const node_state_t s) const
+{
+	return TypedNetwork::getNodes(s);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline typename TypedNetwork<_Node, _Link, _LinkStates>::LinkIteratorRange TypedNetwork<_Node,
+		_Link, _LinkStates>::links() const
+{
+	return TypedNetwork::getLinks();
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline typename TypedNetwork<_Node, _Link, _LinkStates>::LinkStateIteratorRange TypedNetwork<_Node,
+		_Link, _LinkStates>::links(const link_state_t s) const
+{
+	return TypedNetwork::getLinks(s);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline std::pair<bool, node_id_t> TypedNetwork<_Node, _Link, _LinkStates>::randomNode() const
+{
+	return TypedNetwork::getRandomNode();
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline std::pair<bool, node_id_t> TypedNetwork<_Node, _Link, _LinkStates>::randomNode(
+		const node_state_t s) const
+{
+	return TypedNetwork::getRandomNode(s);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline std::pair<bool, node_id_t> TypedNetwork<_Node, _Link, _LinkStates>::randomNode(
+		const state_group_t g) const
+{
+	return TypedNetwork::getRandomNode(g);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline std::pair<bool, link_id_t> TypedNetwork<_Node, _Link, _LinkStates>::randomLink() const
+{
+	return TypedNetwork::getRandomLink();
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline std::pair<bool, link_id_t> TypedNetwork<_Node, _Link, _LinkStates>::randomLink(
+		const link_state_t s) const
+{
+	return TypedNetwork::getRandomLink(s);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline std::pair<bool, link_id_t> TypedNetwork<_Node, _Link, _LinkStates>::randomLink(
+		const state_group_t g) const
+{
+	return TypedNetwork::getRandomLink(g);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline std::pair<bool, link_id_t> TypedNetwork<_Node,
+		_Link, _LinkStates>::randomNeighborLink(const node_id_t n) const
+{
+	return TypedNetwork::getRandomNeighborLink(n);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline std::pair<bool, node_id_t> TypedNetwork<_Node, _Link, _LinkStates>::randomNeighbor(
+		const node_id_t n) const
+{
+	return TypedNetwork::getRandomNeighbor(n);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline std::pair<bool, link_id_t> TypedNetwork<_Node,
+		_Link, _LinkStates>::randomNeighborLink(const node_id_t n, const link_state_t s) const
+{
+	return TypedNetwork::getRandomNeighborLink(n, s);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline std::pair<bool, node_id_t> TypedNetwork<_Node, _Link, _LinkStates>::randomNeighbor(
+		const node_id_t n, const node_state_t s) const
+{
+	return TypedNetwork::getRandomNeighbor(n, s);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+typename TypedNetwork<_Node, _Link, _LinkStates>::NeighborIteratorRange TypedNetwork<_Node,
+		_Link, _LinkStates>::neighbors(const node_id_t n) const
+{
+	return std::make_pair(NeighborIterator(*this, n, node(n).links().first),
+			NeighborIterator(*this, n, node(n).links().second));
+}
+
+template<class _Node, class _Link, class _LinkStates>
+typename TypedNetwork<_Node, _Link, _LinkStates>::NeighborLinkIteratorRange TypedNetwork<
+		_Node, _Link, _LinkStates>::neighborLinks(const node_id_t n) const
+{
+	return node(n).links();
+}
+
+template<class _Node, class _Link, class _LinkStates>
+link_id_t TypedNetwork<_Node, _Link, _LinkStates>::doAddLink(const node_id_t source,
+		const node_id_t target)
+{
+	const link_state_t s = calcLinkState(nodeState(source), nodeState(target));
+#if __cplusplus >= 201103L
+	const link_id_t l = linkStore_->emplace(s, source, target);
+#else
+	const link_id_t l = linkStore_->insert(LinkType(source, target), s);
+#endif
+	attachLink(source, l, true);
+	attachLink(target, l, false);
+	if (edgeIndex_)
+		edgeIndex_->insert(source, target, l);
+	updateLinkEnds(l, true);
+	return l;
+}
+
+template<class _Node, class _Link, class _LinkStates>
+void TypedNetwork<_Node, _Link, _LinkStates>::doAddLinks(const EdgeList& edges)
+{
+	std::vector<link_id_t> ids;
+	insertLinks(edges, ids);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+void TypedNetwork<_Node, _Link, _LinkStates>::insertLinks(const EdgeList& edges,
+		std::vector<link_id_t>& ids)
+{
+	ids.resize(edges.size());
+	if (edges.empty())
+		return;
+	std::vector<LinkType> items;
+	std::vector<link_state_t> states;
+	items.reserve(edges.size());
+	states.reserve(edges.size());
+	for (EdgeList::const_iterator e = edges.begin(); e != edges.end(); ++e)
+	{
+		assert(nodeStore_->valid(e->first) && nodeStore_->valid(e->second));
+		items.push_back(LinkType(e->first, e->second));
+		states.push_back(
+				calcLinkState(nodeState(e->first), nodeState(e->second)));
+	}
+	linkStore_->insertBulk(items.begin(), items.end(), states.begin(),
+			ids.begin());
+
+	reserveAdjacency(edges, typename NodeType::adjacency_category());
+	for (id_size_t i = 0; i < edges.size(); ++i)
+	{
+		attachLink(edges[i].first, ids[i], true);
+		attachLink(edges[i].second, ids[i], false);
+		if (edgeIndex_)
+			edgeIndex_->insert(edges[i].first, edges[i].second, ids[i]);
+		updateLinkEnds(ids[i], true);
+	}
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline void TypedNetwork<_Node, _Link, _LinkStates>::reserveAdjacency(
+		const EdgeList&, set_adjacency_tag)
+{
+}
+
+template<class _Node, class _Link, class _LinkStates>
+template<class _Tag>
+void TypedNetwork<_Node, _Link, _LinkStates>::reserveAdjacency(
+		const EdgeList& edges, _Tag)
+{
+	std::vector<id_size_t> added;
+	for (EdgeList::const_iterator e = edges.begin(); e != edges.end(); ++e)
+	{
+		const node_id_t m = std::max(e->first, e->second);
+		if (m >= added.size())
+			added.resize(m + 1, 0);
+		++added[e->first];
+		++added[e->second];
+	}
+	for (node_id_t n = 0; n < added.size(); ++n)
+	{
+		if (added[n] > 0)
+			node(n).reserve(node(n).degree() + added[n]);
+	}
+}
+
+template<class _Node, class _Link, class _LinkStates>
+bool TypedNetwork<_Node, _Link, _LinkStates>::doChangeLink(const link_id_t l,
+		const node_id_t source, const node_id_t target)
 {
 	LinkType& theLink = link(l);
+	const node_id_t oldSource = theLink.source(), oldTarget = theLink.target();
+	updateLinkEnds(l, false);
 	if (source != theLink.source())
 	{
-		node(theLink.source()).removeLink(l);
+		detachLink(theLink.source(), l, true);
 		theLink.setSource(source);
-		node(source).addLink(l);
+		attachLink(source, l, true);
 	}
 	if (target != theLink.target())
 	{
-		node(theLink.target()).removeLink(l);
+		detachLink(theLink.target(), l, false);
 		theLink.setTarget(target);
-		node(target).addLink(l);
+		attachLink(target, l, false);
+	}
+	updateNeighbor(source, l, true);
+	updateNeighbor(target, l, false);
+	if (edgeIndex_ && !(((oldSource == source) && (oldTarget == target))
+			|| ((oldSource == target) && (oldTarget == source))))
+	{
+		if (edgeIndex_->erase(oldSource, oldTarget, l))
+			edgeIndex_->setLink(oldSource, oldTarget,
+					scanForLink(oldSource, oldTarget).second);
+		edgeIndex_->insert(source, target, l);
 	}
+	updateLinkEnds(l, true);
 	linkStore_->setCategory(l,
-			linkStateCalculator()(getNodeState(source), getNodeState(target)));
+			calcLinkState(nodeState(source), nodeState(target)));
 	return true;
 }
 
+template<class _Node, class _Link, class _LinkStates>
+inline void TypedNetwork<_Node, _Link, _LinkStates>::attachLink(const node_id_t n,
+		const link_id_t l, const bool atSource)
+{
+	attachLink(n, l, atSource, typename NodeType::adjacency_category());
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline void TypedNetwork<_Node, _Link, _LinkStates>::attachLink(const node_id_t n,
+		const link_id_t l, const bool atSource, set_adjacency_tag)
+{
+	const LinkType& theLink = link(l);
+	node(n).addLink(l, atSource ? theLink.target() : theLink.source());
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline void TypedNetwork<_Node, _Link, _LinkStates>::attachLink(const node_id_t n,
+		const link_id_t l, const bool atSource, flat_adjacency_tag)
+{
+	LinkType& theLink = link(l);
+	theLink.setSlot(atSource, node(n).addLink(l,
+			atSource ? theLink.target() : theLink.source()));
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline void TypedNetwork<_Node, _Link, _LinkStates>::detachLink(const node_id_t n,
+		const link_id_t l, const bool atSource)
+{
+	detachLink(n, l, atSource, typename NodeType::adjacency_category());
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline void TypedNetwork<_Node, _Link, _LinkStates>::detachLink(const node_id_t n,
+		const link_id_t l, bool, set_adjacency_tag)
+{
+	node(n).removeLink(l);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+void TypedNetwork<_Node, _Link, _LinkStates>::detachLink(const node_id_t n,
+		const link_id_t l, const bool atSource, flat_adjacency_tag)
+{
+	NodeType& theNode = node(n);
+	const id_size_t slot = link(l).slot(atSource);
+	const id_size_t last = theNode.degree() - 1;
+	const link_id_t moved = theNode.removeLinkAt(slot);
+	if (slot == last)
+		return;
+	// The link formerly in the last slot has been moved. If it is a loop at n,
+	// both its slots are in this list; the one that was last has moved.
+	LinkType& movedLink = link(moved);
+	const bool movedAtSource = (movedLink.source() == n)
+			&& ((movedLink.target() != n) || (movedLink.slot(true) == last));
+	movedLink.setSlot(movedAtSource, slot);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline void TypedNetwork<_Node, _Link, _LinkStates>::updateNeighbor(const node_id_t n,
+		const link_id_t l, const bool atSource)
+{
+	updateNeighbor(n, l, atSource, typename NodeType::adjacency_category());
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline void TypedNetwork<_Node, _Link, _LinkStates>::updateNeighbor(const node_id_t n,
+		const link_id_t l, const bool atSource, set_adjacency_tag)
+{
+	const LinkType& theLink = link(l);
+	node(n).setNeighbor(l, atSource ? theLink.target() : theLink.source());
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline void TypedNetwork<_Node, _Link, _LinkStates>::updateNeighbor(const node_id_t n,
+		const link_id_t l, const bool atSource, flat_adjacency_tag)
+{
+	const LinkType& theLink = link(l);
+	node(n).setNeighbor(theLink.slot(atSource),
+			atSource ? theLink.target() : theLink.source());
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline id_size_t TypedNetwork<_Node, _Link, _LinkStates>::adjacencyGroup(
+		const node_state_t neighborState, const bool atSource)
+{
+	return 2 * neighborState + (atSource ? 0 : 1);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline void TypedNetwork<_Node, _Link, _LinkStates>::attachLink(const node_id_t n,
+		const link_id_t l, const bool atSource, partitioned_adjacency_tag)
+{
+	LinkType& theLink = link(l);
+	const node_id_t m = atSource ? theLink.target() : theLink.source();
+	SlotUpdater upd(*this);
+	theLink.setSlot(atSource, node(n).addLink(l, m,
+			adjacencyGroup(nodeState(m), atSource), upd));
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline void TypedNetwork<_Node, _Link, _LinkStates>::detachLink(const node_id_t n,
+		const link_id_t l, const bool atSource, partitioned_adjacency_tag)
+{
+	SlotUpdater upd(*this);
+	node(n).removeLinkAt(link(l).slot(atSource), upd);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline void TypedNetwork<_Node, _Link, _LinkStates>::updateNeighbor(const node_id_t n,
+		const link_id_t l, const bool atSource, partitioned_adjacency_tag)
+{
+	LinkType& theLink = link(l);
+	const node_id_t m = atSource ? theLink.target() : theLink.source();
+	NodeType& theNode = node(n);
+	SlotUpdater upd(*this);
+	theNode.setNeighbor(theLink.slot(atSource), m);
+	theLink.setSlot(atSource, theNode.moveLinkAt(theLink.slot(atSource),
+			adjacencyGroup(nodeState(m), atSource), upd));
+}
+
+template<class _Node, class _Link, class _LinkStates>
+template<class _Tag>
+inline void TypedNetwork<_Node, _Link, _LinkStates>::regroupNeighbors(node_id_t,
+		node_state_t, _Tag)
+{
+}
+
+template<class _Node, class _Link, class _LinkStates>
+void TypedNetwork<_Node, _Link, _LinkStates>::regroupNeighbors(const node_id_t n,
+		const node_state_t s, partitioned_adjacency_tag)
+{
+	// collect the link ends pointing to n first, since the link list of n
+	// itself changes if there are self-loops
+	std::vector<std::pair<link_id_t, bool> > ends;
+	const NodeType& theNode = node(n);
+	ends.reserve(theNode.degree());
+	for (id_size_t i = 0; i < theNode.degree(); ++i)
+	{
+		const link_id_t l = theNode.linkAt(i);
+		const node_id_t m = theNode.neighborAt(i);
+		// the end of l at m; for a self-loop, the other end of this entry
+		const bool atSource = (m == n) ? (theNode.groupAt(i) % 2 != 0)
+				: (link(l).source() == m);
+		ends.push_back(std::make_pair(l, atSource));
+	}
+	SlotUpdater upd(*this);
+	for (std::vector<std::pair<link_id_t, bool> >::const_iterator it =
+			ends.begin(); it != ends.end(); ++it)
+	{
+		LinkType& theLink = link(it->first);
+		NodeType& m = node(it->second ? theLink.source() : theLink.target());
+		theLink.setSlot(it->second, m.moveLinkAt(theLink.slot(it->second),
+				adjacencyGroup(s, it->second), upd));
+	}
+}
+
+template<class _Node, class _Link, class _LinkStates>
+template<class _Tag>
+void TypedNetwork<_Node, _Link, _LinkStates>::remapLinkList(NodeType& theNode,
+		const IDMap& map, std::vector<Adjacency>& temp, _Tag)
+{
+	typename NodeType::LinkIDIteratorRange iters = theNode.links();
+	temp.clear();
+	for (typename NodeType::LinkIDIterator& li = iters.first; li
+			!= iters.second; ++li)
+		temp.push_back(Adjacency(map.nodes[li.neighbor()], map.links[*li]));
+	theNode.clear();
+	for (std::vector<Adjacency>::const_iterator ai = temp.begin(); ai
+			!= temp.end(); ++ai)
+		theNode.addLink(ai->link, ai->neighbor);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+void TypedNetwork<_Node, _Link, _LinkStates>::remapLinkList(NodeType& theNode,
+		const IDMap& map, std::vector<Adjacency>&, partitioned_adjacency_tag)
+{
+	// slots and groups stay the same
+	for (id_size_t i = 0; i < theNode.degree(); ++i)
+	{
+		theNode.setLink(i, map.links[theNode.linkAt(i)]);
+		theNode.setNeighbor(i, map.nodes[theNode.neighborAt(i)]);
+	}
+}
+
+template<class _Node, class _Link, class _LinkStates>
+template<class _Tag>
+id_size_t TypedNetwork<_Node, _Link, _LinkStates>::countNeighborsInState(const node_id_t n,
+		const node_state_t s, _Tag) const
+{
+	id_size_t count = 0;
+	typename NodeType::LinkIDIteratorRange iters = node(n).links();
+	for (typename NodeType::LinkIDIterator& it = iters.first;
+			it != iters.second; ++it)
+	{
+		if (nodeState(it.neighbor()) == s)
+			++count;
+	}
+	return count;
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline id_size_t TypedNetwork<_Node, _Link, _LinkStates>::countNeighborsInState(
+		const node_id_t n, const node_state_t s, partitioned_adjacency_tag) const
+{
+	const NodeType& theNode = node(n);
+	return theNode.count(adjacencyGroup(s, true)) + theNode.count(
+			adjacencyGroup(s, false));
+}
+
+template<class _Node, class _Link, class _LinkStates>
+template<class _Tag>
+std::pair<bool, link_id_t> TypedNetwork<_Node, _Link, _LinkStates>::randomNeighborLinkInState(
+		const node_id_t n, const link_state_t s, _Tag) const
+{
+	std::pair<bool, link_id_t> ret = std::make_pair(false, 0);
+	id_size_t count = 0;
+	NeighborLinkIteratorRange iters = neighborLinks(n);
+	for (NeighborLinkIterator it = iters.first; it != iters.second; ++it)
+	{
+		if (linkState(*it) == s)
+			++count;
+	}
+	if (count == 0)
+		return ret;
+	id_size_t num = rng.IntFromTo<id_size_t>(0, count - 1);
+	for (NeighborLinkIterator& it = iters.first; it != iters.second; ++it)
+	{
+		if ((linkState(*it) == s) && (num-- == 0))
+		{
+			ret.first = true;
+			ret.second = *it;
+			break;
+		}
+	}
+	return ret;
+}
+
+template<class _Node, class _Link, class _LinkStates>
+std::pair<bool, link_id_t> TypedNetwork<_Node, _Link, _LinkStates>::randomNeighborLinkInState(
+		const node_id_t n, const link_state_t s, partitioned_adjacency_tag) const
+{
+	// the links in each group share their link state, which depends on the
+	// neighbor state and the direction of the link
+	std::pair<bool, link_id_t> ret = std::make_pair(false, 0);
+	const NodeType& theNode = node(n);
+	const node_state_t ns = nodeState(n);
+	id_size_t count = 0;
+	for (node_state_t t = 0; t < numberOfNodeStates(); ++t)
+	{
+		if (calcLinkState(ns, t) == s)
+			count += theNode.count(adjacencyGroup(t, true));
+		if (calcLinkState(t, ns) == s)
+			count += theNode.count(adjacencyGroup(t, false));
+	}
+	if (count == 0)
+		return ret;
+	id_size_t num = rng.IntFromTo<id_size_t>(0, count - 1);
+	for (node_state_t t = 0; t < numberOfNodeStates(); ++t)
+	{
+		for (int d = 0; d < 2; ++d)
+		{
+			const bool atSource = (d == 0);
+			if ((atSource ? calcLinkState(ns, t) : calcLinkState(t, ns)) != s)
+				continue;
+			const id_size_t g = adjacencyGroup(t, atSource);
+			if (num < theNode.count(g))
+			{
+				ret.first = true;
+				ret.second = theNode.linkAt(theNode.slotInGroup(g, num));
+				return ret;
+			}
+			num -= theNode.count(g);
+		}
+	}
+	return ret;
+}
+
+template<class _Node, class _Link, class _LinkStates>
+template<class _Tag>
+std::pair<bool, node_id_t> TypedNetwork<_Node, _Link, _LinkStates>::randomNeighborInState(
+		const node_id_t n, const node_state_t s, _Tag) const
+{
+	std::pair<bool, node_id_t> ret = std::make_pair(false, 0);
+	const id_size_t count = neighborsInState(n, s);
+	if (count == 0)
+		return ret;
+	id_size_t num = rng.IntFromTo<id_size_t>(0, count - 1);
+	NeighborLinkIteratorRange iters = neighborLinks(n);
+	for (NeighborLinkIterator& it = iters.first; it != iters.second; ++it)
+	{
+		if ((nodeState(it.neighbor()) == s) && (num-- == 0))
+		{
+			ret.first = true;
+			ret.second = it.neighbor();
+			break;
+		}
+	}
+	return ret;
+}
+
+template<class _Node, class _Link, class _LinkStates>
+std::pair<bool, node_id_t> TypedNetwork<_Node, _Link, _LinkStates>::randomNeighborInState(
+		const node_id_t n, const node_state_t s, partitioned_adjacency_tag) const
+{
+	std::pair<bool, node_id_t> ret = std::make_pair(false, 0);
+	const NodeType& theNode = node(n);
+	const id_size_t g = adjacencyGroup(s, true), h = adjacencyGroup(s, false);
+	const id_size_t count = theNode.count(g) + theNode.count(h);
+	if (count == 0)
+		return ret;
+	const id_size_t num = rng.IntFromTo<id_size_t>(0, count - 1);
+	ret.first = true;
+	ret.second = theNode.neighborAt((num < theNode.count(g))
+			? theNode.slotInGroup(g, num)
+			: theNode.slotInGroup(h, num - theNode.count(g)));
+	return ret;
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline link_state_t TypedNetwork<_Node, _Link, _LinkStates>::calcLinkState(
+		const node_state_t source, const node_state_t target) const
+{
+	assert(calc_ != 0);
+	return detail::linkState(*calc_, source, target);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline void TypedNetwork<_Node, _Link, _LinkStates>::bindLinkStateCalculator()
+{
+	calc_ = dynamic_cast<const _LinkStates*> (&linkStateCalculator());
+	assert(calc_ != 0);
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline bool TypedNetwork<_Node, _Link, _LinkStates>::getLinkStateCalculatorSupported(
+		const LinkStateCalculator& lc) const
+{
+	const LinkStateCalculator* const p = &lc;
+	return dynamic_cast<const _LinkStates*> (p) != 0;
+}
+
+template<class _Node, class _Link, class _LinkStates>
+inline LinkStateCalculator* TypedNetwork<_Node, _Link, _LinkStates>::newDefaultLinkStateCalculator(
+		const node_state_size_t nNodeStates) const
+{
+	return detail::DefaultLinkStates<_LinkStates>::create(nNodeStates);
+}
+
 //================ NeighborIterator implementation ======================
-template<class _Node, class _Link>
-TypedNetwork<_Node, _Link>::NeighborIterator::NeighborIterator() :
+template<class _Node, class _Link, class _LinkStates>
+TypedNetwork<_Node, _Link, _LinkStates>::NeighborIterator::NeighborIterator() :
 		net_(0), n_(0)
 {
 }
 
-template<class _Node, class _Link>
-TypedNetwork<_Node, _Link>::NeighborIterator::NeighborIterator(
-		const TypedNetwork<_Node, _Link>& net, const node_id_t n,
-		const typename NodeType::LinkSet::iterator val) :
+template<class _Node, class _Link, class _LinkStates>
+TypedNetwork<_Node, _Link, _LinkStates>::NeighborIterator::NeighborIterator(
+		const TypedNetwork<_Node, _Link, _LinkStates>& net, const node_id_t n,
+		const typename NodeType::LinkIDIterator val) :
 		net_(&net), n_(n), cur_(val)
 {
 }
 
-template<class _Node, class _Link>
-TypedNetwork<_Node, _Link>::NeighborIterator::NeighborIterator(
-		const typename TypedNetwork<_Node, _Link>::NeighborIterator& it) :
+template<class _Node, class _Link, class _LinkStates>
+TypedNetwork<_Node, _Link, _LinkStates>::NeighborIterator::NeighborIterator(
+		const typename TypedNetwork<_Node, _Link, _LinkStates>::NeighborIterator& it) :
 		net_(it.net_), n_(it.n_), cur_(it.cur_)
 {
 }
 
-template<class _Node, class _Link>
-TypedNetwork<_Node, _Link>::NeighborIterator::~NeighborIterator()
+template<class _Node, class _Link, class _LinkStates>
+TypedNetwork<_Node, _Link, _LinkStates>::NeighborIterator::~NeighborIterator()
 {
 }
 
-template<class _Node, class _Link>
-typename TypedNetwork<_Node, _Link>::NeighborIterator& TypedNetwork<_Node, _Link>::NeighborIterator::operator=(
-		const typename TypedNetwork<_Node, _Link>::NeighborIterator& it)
+template<class _Node, class _Link, class _LinkStates>
+typename TypedNetwork<_Node, _Link, _LinkStates>::NeighborIterator& TypedNetwork<_Node, _Link, _LinkStates>::NeighborIterator::operator=(
+		const typename TypedNetwork<_Node, _Link, _LinkStates>::NeighborIterator& it)
 {
 	net_ = it.net_;
 	n_ = it.n_;
@@ -895,30 +2282,30 @@ typename TypedNetwork<_Node, _Link>::NeighborIterator& TypedNetwork<_Node, _Link
 	return *this;
 }
 
-template<class _Node, class _Link>
-bool TypedNetwork<_Node, _Link>::NeighborIterator::operator==(
-		const typename TypedNetwork<_Node, _Link>::NeighborIterator& it)
+template<class _Node, class _Link, class _LinkStates>
+bool TypedNetwork<_Node, _Link, _LinkStates>::NeighborIterator::operator==(
+		const typename TypedNetwork<_Node, _Link, _LinkStates>::NeighborIterator& it)
 {
 	return (net_ == it.net_) && (cur_ == it.cur_) && (n_ == it.n_);
 }
 
-template<class _Node, class _Link>
-bool TypedNetwork<_Node, _Link>::NeighborIterator::operator!=(
-		const typename TypedNetwork<_Node, _Link>::NeighborIterator& it)
+template<class _Node, class _Link, class _LinkStates>
+bool TypedNetwork<_Node, _Link, _LinkStates>::NeighborIterator::operator!=(
+		const typename TypedNetwork<_Node, _Link, _LinkStates>::NeighborIterator& it)
 {
 	return !this->operator==(it);
 }
 
-template<class _Node, class _Link>
-typename TypedNetwork<_Node, _Link>::NeighborIterator& TypedNetwork<_Node, _Link>::NeighborIterator::operator++()
+template<class _Node, class _Link, class _LinkStates>
+typename TypedNetwork<_Node, _Link, _LinkStates>::NeighborIterator& TypedNetwork<_Node, _Link, _LinkStates>::NeighborIterator::operator++()
 {
 	assert(net_ != 0);
 	++cur_;
 	return *this;
 }
 
-template<class _Node, class _Link>
-typename TypedNetwork<_Node, _Link>::NeighborIterator TypedNetwork<_Node, _Link>::NeighborIterator::operator++(
+template<class _Node, class _Link, class _LinkStates>
+typename TypedNetwork<_Node, _Link, _LinkStates>::NeighborIterator TypedNetwork<_Node, _Link, _LinkStates>::NeighborIterator::operator++(
 		int)
 {
 	NeighborIterator tmp(*this);
@@ -926,11 +2313,11 @@ typename TypedNetwork<_Node, _Link>::NeighborIterator TypedNetwork<_Node, _Link>
 	return (tmp);
 }
 
-template<class _Node, class _Link>
-node_id_t TypedNetwork<_Node, _Link>::NeighborIterator::operator*()
+template<class _Node, class _Link, class _LinkStates>
+node_id_t TypedNetwork<_Node, _Link, _LinkStates>::NeighborIterator::operator*()
 {
 	assert(net_ != 0);
-	return net_->link(*cur_).opposite(n_);
+	return cur_.neighbor();
 }
 
 }
@@ -26,16 +26,56 @@
 #include <largenet/base/repo/types.h>
 #include <largenet/base/repo/repo_base.h>
 #include <largenet/base/repo/iterators.h>
+#include <largenet/base/repo/growth.h>
 #include <vector>
 #include <utility>	// for std::pair
 #include <iterator>
 #include <exception>
 #include <cassert>
 #include <algorithm>
+#include <new>
 
 namespace repo
 {
 
+/**
+ * Reset an item after it has been removed from a CategorizedRepository. The
+ * default assigns a default-constructed item. Overload this in the item's
+ * namespace for types that can be cleared in place, keeping their storage.
+ * @param itm Item to reset.
+ */
+template<class T>
+inline void resetItem(T& itm)
+{
+	itm = T();
+}
+
+#if __cplusplus >= 201103L
+/**
+ * Turn the reset item @p itm in a free slot of a CategorizedRepository into
+ * an item constructed from @p args (see CategorizedRepository::emplace()).
+ * The default destroys @p itm and constructs the new item in its place.
+ * Overload this in the item's namespace for types that can be set up in
+ * place, keeping the storage that resetItem() kept.
+ * @param itm Reset item to replace.
+ * @param args Arguments to the item's constructor.
+ */
+template<class T, class... Args>
+inline void emplaceItem(T& itm, Args&&... args)
+{
+	itm.~T();
+	try
+	{
+		::new (static_cast<void*>(&itm)) T(std::forward<Args>(args)...);
+	} catch (...)
+	{
+		// the slot must hold a valid item again
+		::new (static_cast<void*>(&itm)) T();
+		throw;
+	}
+}
+#endif
+
 /**
  * A categorized repository of items.
  *
@@ -44,6 +84,14 @@ namespace repo
  * @c CategorizedRepository features efficient access to objects and can handle some
  * additional tasks.
  *
+ * Each category keeps its own list of item IDs, so changing an item's category
+ * takes constant time regardless of how far apart the two categories are.
+ * Numbering items across all categories (id(address_t)) costs O(log C) for
+ * C categories.
+ *
+ * Storage grows according to @p GrowthPolicy (see growth.h) when an item is
+ * inserted into a full repository; use reserve() to allocate space up front.
+ *
  * @author Gerd Zschaler <zschaler@pks.mpg.de>, original concept by Thilo Gross <gross@physics.org>
  *
  * @see Class @c CRepository by Thilo Gross <gross@physics.org>.
@@ -51,8 +99,7 @@ namespace repo
  * @todo Better remove the index operators and @c [], and rename @c item(address_t) and @c item(id_t) to
  * something clearer to prevent confusion and ambiguities.
  */
-template<class T, unsigned int enlarge_factor = 10, unsigned int max_size =
-		100000000>
+template<class T, class GrowthPolicy = DefaultGrowth>
 class CategorizedRepository: public _Repo_base
 {
 public:
@@ -93,9 +140,10 @@ public:
 	CategorizedRepository(category_t cat, address_t N);
 	/**
 	 * Copy constructor. Creates a new repository that contains copies of
-	 * all <i>valid</i> items from @p r in their respective categories.
-	 * Items with invalid IDs are dropped, i.e. item IDs may differ from
-	 * IDs in the original repository.
+	 * all items from @p r in their respective categories, under the same IDs.
+	 * All internal arrays are copied wholesale, so this costs little more than
+	 * copying the items themselves. Use compact() on the copy to get
+	 * consecutive IDs.
 	 *
 	 * @param r	CategorizedRepository to copy from
 	 */
@@ -115,6 +163,22 @@ public:
 	 */
 	void setNumberOfCategories(category_t n);
 
+	/**
+	 * Make sure that at least @p n items can be stored without further
+	 * allocations. Never shrinks the repository.
+	 * @param n Number of items to allocate space for.
+	 */
+	void reserve(address_t n);
+
+	/**
+	 * Renumber all items with consecutive IDs 0, ..., size() - 1, keeping their
+	 * order and categories. Afterwards, iterating over all items does not need
+	 * to skip unused IDs. Stored references to item IDs must be translated
+	 * using the returned map.
+	 * @return Map from old to new IDs. IDs that were not in use map to INVALID_ID.
+	 */
+	std::vector<id_t> compact();
+
 	/**
 	 * Return category of item with number @p n.
 	 * @param n Number of item.
@@ -164,6 +228,15 @@ public:
 	 * @return Unique ID of item
 	 */
 	id_t id(category_t cat, address_t n) const;
+	/**
+	 * Return ID of @p n 'th item in category group @p g (see addGroup()).
+	 * Drawing @p n uniformly from 0, ..., count(g) - 1 picks an item
+	 * uniformly from all categories of the group.
+	 * @param g Category group
+	 * @param n Number of item in group @p g
+	 * @return Unique ID of item
+	 */
+	id_t id(group_t g, address_t n) const;
 
 	/**
 	 * Insert a copy of @p itm into category @p cat
@@ -171,13 +244,65 @@ public:
 	 * @param cat Category to insert the item into.
 	 * @return Unique ID of inserted item.
 	 */
-	id_t insert(T itm, category_t cat);
+	id_t insert(const T& itm, category_t cat);
 	/**
 	 * Insert a copy of @p itm into the repository.
 	 * @param itm Item to insert into the repository.
 	 * @return Unique ID of inserted item.
 	 */
-	id_t insert(T itm);
+	id_t insert(const T& itm);
+#if __cplusplus >= 201103L
+	/**
+	 * Move @p itm into category @p cat.
+	 * @param itm Item to move into the repository.
+	 * @param cat Category to insert the item into.
+	 * @return Unique ID of inserted item.
+	 */
+	id_t insert(T&& itm, category_t cat);
+	/**
+	 * Move @p itm into the repository.
+	 * @param itm Item to move into the repository.
+	 * @return Unique ID of inserted item.
+	 */
+	id_t insert(T&& itm);
+	/**
+	 * Construct an item from @p args in category @p cat. The item is
+	 * constructed in the storage of a free slot through emplaceItem(), so
+	 * that item types overloading it can reuse the memory their reset items
+	 * keep.
+	 * @param cat Category to insert the item into.
+	 * @param args Arguments to the item's constructor.
+	 * @return Unique ID of inserted item.
+	 */
+	template<class... Args>
+	id_t emplace(category_t cat, Args&&... args);
+#endif
+	/**
+	 * Insert copies of the items in [@p first, @p last) into the categories
+	 * given by the range starting at @p cats. Storage is allocated once and
+	 * category counts are updated in one pass at the end, so this takes
+	 * O(N + C) time for N items and C categories.
+	 * @param first Forward iterator to first item.
+	 * @param last Past-the-end item iterator.
+	 * @param cats Forward iterator to the category of the first item.
+	 * @param ids Output iterator receiving the unique IDs of the inserted items.
+	 * @return Output iterator past the last ID written.
+	 */
+	template<class InputIterator, class CatIterator, class OutputIterator>
+	OutputIterator insertBulk(InputIterator first, InputIterator last,
+			CatIterator cats, OutputIterator ids);
+
+	/**
+	 * Set the categories of all items with IDs in [@p first, @p last) to the
+	 * categories given by the range starting at @p cats. Category counts are
+	 * updated in one pass at the end, so this takes O(N + C) time for N items
+	 * and C categories.
+	 * @param first Iterator to first unique ID.
+	 * @param last Past-the-end ID iterator.
+	 * @param cats Iterator to the new category of the first item.
+	 */
+	template<class IDIterator, class CatIterator>
+	void setCategories(IDIterator first, IDIterator last, CatIterator cats);
 
 	/**
 	 * Remove item from repository. The item is not destroyed but returned.
@@ -215,7 +340,7 @@ public:
 	 * @param itm Item to insert into the repository
 	 * @return reference to self (for operator concatenation)
 	 */
-	CategorizedRepository<T, enlarge_factor, max_size>& operator<<(T itm);
+	CategorizedRepository<T, GrowthPolicy>& operator<<(const T& itm);
 
 	/**
 	 * Return an iterator referring to the first item stored in the repository.
@@ -251,42 +376,11 @@ public:
 
 private:
 	void init();
-	void copyItems(const CategorizedRepository& r);
-	/**
-	 * Set category of item with number @p n.
-	 * @param n Number of item.
-	 * @param cat Category to put item into.
-	 */
-	void setCategory(address_t n, category_t cat);
-	/**
-	 * Set category of @p n 'th item in category @p oldCat to @p newCat
-	 * @param oldCat Category the item is in.
-	 * @param n Number of item in category @p oldCat
-	 * @param newCat New category for item.
-	 */
-	void setCategory(category_t oldCat, address_t n, category_t newCat);
-
-	/**
-	 * Return item with number @p n.
-	 * @param n Number of item
-	 * @return Reference to item
-	 */
-	reference item(address_t n);
-	const_reference item(address_t n) const;
-
-	/**
-	 * Remove @p n 'th item from repository.
-	 * The item is not destroyed but returned.
-	 * @param n Number of item to remove
-	 * @return Removed item.
-	 */
-	void remove(address_t n);
 
-	bool enlarge(); ///< enlarge the storage space
-	void increaseCat(address_t n, category_t cat); ///< increase category of entry
-	void decreaseCat(address_t n, category_t cat); ///< decrease category of entry
-
-	void reorderToMaxCategory(const category_t n);
+	bool enlarge(address_t minFree = 1); ///< enlarge the storage space according to GrowthPolicy
+	void resize(address_t newsize); ///< resize storage space to @p newsize items
+	id_t freeID(); ///< return the ID the next item will be stored at, enlarging if necessary
+	void store(id_t uid, category_t cat); ///< file newly stored item @p uid under category @p cat
 
 	std::vector<T> items_; ///< array of items
 
@@ -294,16 +388,16 @@ private:
 
 // --------------- construction/destruction
 
-template<class T, unsigned int enlarge_factor, unsigned int max_size>
-CategorizedRepository<T, enlarge_factor, max_size>::CategorizedRepository(
+template<class T, class GrowthPolicy>
+CategorizedRepository<T, GrowthPolicy>::CategorizedRepository(
 		const category_t cat) :
 	_Repo_base(cat, 100), items_(N_)
 {
 	init();
 }
 
-template<class T, unsigned int enlarge_factor, unsigned int max_size>
-CategorizedRepository<T, enlarge_factor, max_size>::CategorizedRepository(
+template<class T, class GrowthPolicy>
+CategorizedRepository<T, GrowthPolicy>::CategorizedRepository(
 		const category_t cat, const address_t N) :
 	_Repo_base(cat, N), items_(N_)
 {
@@ -311,246 +405,175 @@ CategorizedRepository<T, enlarge_factor, max_size>::CategorizedRepository(
 	init();
 }
 
-template<class T, unsigned int enlarge_factor, unsigned int max_size>
-CategorizedRepository<T, enlarge_factor, max_size>::CategorizedRepository(
-		const CategorizedRepository<T, enlarge_factor, max_size>& r) :
-	_Repo_base(r), items_(N_)
+template<class T, class GrowthPolicy>
+CategorizedRepository<T, GrowthPolicy>::CategorizedRepository(
+		const CategorizedRepository<T, GrowthPolicy>& r) :
+	_Repo_base(r), items_(r.items_)
 {
-	init();
-	copyItems(r);
 }
 
-template<class T, unsigned int enlarge_factor, unsigned int max_size>
-void CategorizedRepository<T, enlarge_factor, max_size>::init()
+template<class T, class GrowthPolicy>
+void CategorizedRepository<T, GrowthPolicy>::init()
 {
 	items_.reserve(N_);
 	items_.resize(N_);
 }
 
-template<class T, unsigned int enlarge_factor, unsigned int max_size>
-void CategorizedRepository<T, enlarge_factor, max_size>::copyItems(
-		const CategorizedRepository<T, enlarge_factor, max_size>& r)
+template<class T, class GrowthPolicy>
+CategorizedRepository<T, GrowthPolicy>& CategorizedRepository<T, GrowthPolicy>::operator=(const CategorizedRepository<T, GrowthPolicy>& r)
 {
-	assert(C_ == r.C_);
-	IndexIteratorRange iters = r.ids();
-	for (IndexIterator it = iters.first; it != iters.second; ++it)
-	{
-		insert(r.item(*it), r.category(*it));
-	}
-}
-
-template<class T, unsigned int enlarge_factor, unsigned int max_size>
-CategorizedRepository<T, enlarge_factor, max_size>& CategorizedRepository<T,
-		enlarge_factor, max_size>::operator=(const CategorizedRepository<T,
-		enlarge_factor, max_size>& r)
-{
-	C_ = r.C_;
-	N_ = r.nStored_;
-	_init();
-	init();
-	copyItems(r);
+	_Repo_base::operator=(r);
+	items_ = r.items_;
 	return *this;
 }
 
-template<class T, unsigned int enlarge_factor, unsigned int max_size>
-CategorizedRepository<T, enlarge_factor, max_size>::~CategorizedRepository()
+template<class T, class GrowthPolicy>
+CategorizedRepository<T, GrowthPolicy>::~CategorizedRepository()
 {
 }
 
-template<class T, unsigned int enlarge_factor, unsigned int max_size>
-void CategorizedRepository<T, enlarge_factor, max_size>::setNumberOfCategories(
+template<class T, class GrowthPolicy>
+void CategorizedRepository<T, GrowthPolicy>::setNumberOfCategories(
 		const category_t n)
 {
-	if (n == 0)
+	if ((n == 0) || (n == C_))
 		return;
-	if (nStored_ > 0)
-		reorderToMaxCategory(n - 1);
-	address_t oldCCount = count_[C_];
-	address_t oldCOffset = offset_[C_];
-	category_t oldC = C_;
-	C_ = n;
-	count_.resize(C_ + 1, 0);
-	offset_.resize(C_ + 1, oldCOffset);
-	count_[oldC] = 0;
-	count_[C_] = oldCCount;
-	offset_[C_] = oldCOffset;
-}
-
-template<class T, unsigned int enlarge_factor, unsigned int max_size>
-void CategorizedRepository<T, enlarge_factor, max_size>::reorderToMaxCategory(
-		const category_t n)
-{
-	if (n >= C_ - 1)
-		return;
-
-	// first id to move should be ids_[offset_[n+1]], last ids_[offset_[C_]-1]
-	// number of ids to move should be offset_[C_] - offset_[n+1]
-
-	id_size_t num = offset_[C_] - offset_[n + 1];
-	std::vector<id_t> temp(num, 0);
-	std::copy(ids_.begin() + offset_[n + 1], ids_.begin() + offset_[C_],
-			temp.begin());
-
-	for (std::vector<id_t>::const_iterator it = temp.begin(); it != temp.end(); ++it)
+	id_vector free;
+	free.swap(ids_[C_]);
+	// put all items with category >= n into the new maximum category n - 1
+	for (category_t c = n; c < C_; ++c)
 	{
-		decreaseCat(nums_[*it], n);
+		for (id_vector::const_iterator it = ids_[c].begin(); it
+				!= ids_[c].end(); ++it)
+		{
+			nums_[*it] = ids_[n - 1].size();
+			ids_[n - 1].push_back(*it);
+			cats_[*it] = n - 1;
+		}
 	}
+	ids_.resize(n + 1);
+	ids_[n].clear();
+	ids_[n].swap(free);
+	for (id_vector::const_iterator it = ids_[n].begin(); it != ids_[n].end(); ++it)
+		cats_[*it] = n;
+	C_ = n;
+	rebuildGroupMembership();
+	rebuildCountTree();
+	rebuildWeightTrees();
 }
 
-template<class T, unsigned int enlarge_factor, unsigned int max_size>
-void CategorizedRepository<T, enlarge_factor, max_size>::clear()
+template<class T, class GrowthPolicy>
+void CategorizedRepository<T, GrowthPolicy>::clear()
 {
 	assert(C_ > 0);
-	init();
+	_init();
+	items_.assign(N_, T());
 }
 
-template<class T, unsigned int enlarge_factor, unsigned int max_size>
-bool CategorizedRepository<T, enlarge_factor, max_size>::enlarge()
+template<class T, class GrowthPolicy>
+bool CategorizedRepository<T, GrowthPolicy>::enlarge(const address_t minFree)
 {
-	address_t newsize = (N_ > 0) ? N_ * enlarge_factor : enlarge_factor;
-	if (newsize > max_size)
-		newsize = max_size;
-	if (newsize <= N_)
-		return false;
-	else
+	const address_t needed = N_ + minFree - ids_[C_].size();
+	address_t newsize = N_;
+	do
 	{
-		items_.reserve(newsize);
-		items_.resize(newsize); // fills with default-constructed items
-
-		ids_.reserve(newsize);
-		for (address_t i = N_; i < newsize; ++i)
-			ids_.push_back(i);
-
-		nums_.reserve(newsize);
-		for (id_t i = N_; i < newsize; ++i)
-			nums_.push_back(i);
-
-		count_[C_] += newsize - N_;
-		N_ = newsize;
-		return true;
-	}
+		const address_t next = GrowthPolicy::newCapacity(newsize);
+		if (next <= newsize)
+			return false;
+		newsize = next;
+	} while (newsize < needed);
+	resize(newsize);
+	return true;
 }
 
-// --------------- category management
+template<class T, class GrowthPolicy>
+void CategorizedRepository<T, GrowthPolicy>::reserve(const address_t n)
+{
+	if (n > N_)
+		resize(n);
+}
 
-template<class T, unsigned int enlarge_factor, unsigned int max_size>
-void CategorizedRepository<T, enlarge_factor, max_size>::increaseCat(
-		const address_t n, const category_t cat)
-{
-	assert(n < N_);
-	assert(cat <= C_);
-	category_t cls = category(n);
-	address_t mynum = n;
-	id_t myid = ids_[mynum];
-	assert(cls <= cat);
-	while (cls < cat) // Keep increasing
+template<class T, class GrowthPolicy>
+void CategorizedRepository<T, GrowthPolicy>::resize(const address_t newsize)
+{
+	assert(newsize > N_);
 	{
-		// First go to last pos in current group
-		address_t tarnum = offset_[cls] + count_[cls] - 1;
-		if (mynum != tarnum)
-		{
-			id_t idbuf = ids_[tarnum];
-			ids_[tarnum] = ids_[mynum];
-			ids_[mynum] = idbuf;
-			nums_[myid] = tarnum; // This is right cause we switched nums
-			nums_[idbuf] = mynum;
-			mynum = tarnum;
-		}
-		--count_[cls]; // Now shift the boundary
-		++count_[cls + 1];
-		--offset_[cls + 1];
-		++cls;
+		// swap items over, so that items owning memory are not copied
+		std::vector<T> newItems(newsize);
+		using std::swap;
+		for (id_t i = 0; i < N_; ++i)
+			swap(newItems[i], items_[i]);
+		items_.swap(newItems);
 	}
-}
 
-template<class T, unsigned int enlarge_factor, unsigned int max_size>
-void CategorizedRepository<T, enlarge_factor, max_size>::decreaseCat(
-		const address_t n, const category_t cat)
-{
-	assert(n < N_);
-	assert(cat <= C_);
-	category_t cls = category(n);
-	address_t mynum = n;
-	id_t myid = ids_[mynum];
-	assert(cls >= cat);
-	while (cls > cat) // Keep decreasing
+	nums_.resize(newsize);
+	cats_.resize(newsize, C_);
+	if (hasWeights())
+		weights_.resize(newsize, 1.0);
+	rebuildOccupancy();
+
+	// new IDs go below the current free ones, lowest ID on top
+	id_vector& free = ids_[C_];
+	id_vector newFree;
+	newFree.reserve(newsize - N_ + free.size());
+	for (address_t i = newsize; i > N_; --i)
+		newFree.push_back(i - 1);
+	newFree.insert(newFree.end(), free.begin(), free.end());
+	free.swap(newFree);
+	for (address_t i = 0; i < free.size(); ++i)
+		nums_[free[i]] = i;
+
+	N_ = newsize;
+}
+
+template<class T, class GrowthPolicy>
+std::vector<id_t> CategorizedRepository<T, GrowthPolicy>::compact()
+{
+	std::vector<id_t> map;
+	compactIDs(map);
+	// slots below the current one that have not been filled yet hold
+	// reset items, so swapping leaves those behind
+	using std::swap;
+	for (id_t i = 0; i < map.size(); ++i)
 	{
-		// First go to first pos in current group
-		address_t tarnum = offset_[cls];
-		if (mynum != tarnum)
-		{
-			id_t idbuf = ids_[tarnum];
-			ids_[tarnum] = ids_[mynum];
-			ids_[mynum] = idbuf;
-			nums_[myid] = tarnum; // This is right cause we switched nums
-			nums_[idbuf] = mynum;
-			mynum = tarnum;
-		}
-		--count_[cls]; // Now shift the boundary
-		++count_[cls - 1];
-		++offset_[cls];
-		--cls;
+		if ((map[i] != INVALID_ID) && (map[i] != i))
+			swap(items_[map[i]], items_[i]);
 	}
+	return map;
 }
 
-template<class T, unsigned int enlarge_factor, unsigned int max_size>
-inline category_t CategorizedRepository<T, enlarge_factor, max_size>::category(
+// --------------- category management
+
+template<class T, class GrowthPolicy>
+inline category_t CategorizedRepository<T, GrowthPolicy>::category(
 		const id_t id) const
 {
 	assert(id < N_);
-	return category(nums_[id]);
+	return cats_[id];
 }
 
-template<class T, unsigned int enlarge_factor, unsigned int max_size>
-inline category_t CategorizedRepository<T, enlarge_factor, max_size>::category(
+template<class T, class GrowthPolicy>
+inline category_t CategorizedRepository<T, GrowthPolicy>::category(
 		const address_t n) const
 {
-	assert(n < N_);
+	assert(n < nStored_);
 	address_t na = n;
-	category_t c = 0;
-	while (na >= count_[c])
-	{
-		na -= count_[c];
-		++c;
-	}
-	return c;
+	return findCategory(na);
 }
 
-template<class T, unsigned int enlarge_factor, unsigned int max_size>
-void CategorizedRepository<T, enlarge_factor, max_size>::setCategory(
+template<class T, class GrowthPolicy>
+inline void CategorizedRepository<T, GrowthPolicy>::setCategory(
 		const id_t id, const category_t cat)
 {
 	assert(id < N_);
-	setCategory(nums_[id], cat);
-}
-
-template<class T, unsigned int enlarge_factor, unsigned int max_size>
-void CategorizedRepository<T, enlarge_factor, max_size>::setCategory(
-		const address_t n, const category_t cat)
-{
+	assert(valid(id));
 	assert(cat < C_);
-	assert(n <= nStored_);
-	category_t cls = category(n);
-	if (cls < cat)
-		increaseCat(n, cat);
-	else
-		decreaseCat(n, cat);
+	moveToCategory(id, cat);
 }
 
-template<class T, unsigned int enlarge_factor, unsigned int max_size>
-void CategorizedRepository<T, enlarge_factor, max_size>::setCategory(
-		const category_t oldCat, const address_t n, const category_t newCat)
-{
-	assert(oldCat < C_);
-	assert(n < count_[oldCat]);
-	assert(newCat < C_);
-	address_t num = offset_[oldCat] + n;
-	setCategory(num, newCat);
-}
-
-template<class T, unsigned int enlarge_factor, unsigned int max_size>
-inline/* */typename CategorizedRepository<T, enlarge_factor, max_size>::reference
-CategorizedRepository<T, enlarge_factor, max_size>::item(
+template<class T, class GrowthPolicy>
+inline/* */typename CategorizedRepository<T, GrowthPolicy>::reference
+CategorizedRepository<T, GrowthPolicy>::item(
 		const id_t id)
 {
 	assert(id < N_);
@@ -558,9 +581,9 @@ CategorizedRepository<T, enlarge_factor, max_size>::item(
 	return items_[id];
 }
 
-template<class T, unsigned int enlarge_factor, unsigned int max_size>
-inline typename CategorizedRepository<T, enlarge_factor, max_size>::const_reference
-CategorizedRepository<T, enlarge_factor, max_size>::item(
+template<class T, class GrowthPolicy>
+inline typename CategorizedRepository<T, GrowthPolicy>::const_reference
+CategorizedRepository<T, GrowthPolicy>::item(
 		const id_t id) const
 {
 	assert(id < N_);
@@ -568,154 +591,232 @@ CategorizedRepository<T, enlarge_factor, max_size>::item(
 	return items_[id];
 }
 
-template<class T, unsigned int enlarge_factor, unsigned int max_size>
-inline typename CategorizedRepository<T, enlarge_factor, max_size>::reference
-CategorizedRepository<T, enlarge_factor, max_size>::operator[](
+template<class T, class GrowthPolicy>
+inline typename CategorizedRepository<T, GrowthPolicy>::reference
+CategorizedRepository<T, GrowthPolicy>::operator[](
 		const id_t id)
 {
 	return item(id);
 }
 
-template<class T, unsigned int enlarge_factor, unsigned int max_size>
-inline typename CategorizedRepository<T, enlarge_factor, max_size>::const_reference
-CategorizedRepository<T, enlarge_factor, max_size>::operator[](
+template<class T, class GrowthPolicy>
+inline typename CategorizedRepository<T, GrowthPolicy>::const_reference
+CategorizedRepository<T, GrowthPolicy>::operator[](
 		const id_t id) const
 {
 	return item(id);
 }
 
-template<class T, unsigned int enlarge_factor, unsigned int max_size>
-inline typename CategorizedRepository<T, enlarge_factor, max_size>::reference
-CategorizedRepository<T, enlarge_factor, max_size>::item(
-		const address_t n)
+template<class T, class GrowthPolicy>
+inline typename CategorizedRepository<T, GrowthPolicy>::reference
+CategorizedRepository<T, GrowthPolicy>::item(
+		const category_t cat, const address_t n)
 {
-	assert(n < N_);
-	assert(valid(ids_[n]));
-	return items_[ids_[n]];
+	return items_[id(cat, n)];
 }
 
-template<class T, unsigned int enlarge_factor, unsigned int max_size>
-inline typename CategorizedRepository<T, enlarge_factor, max_size>::const_reference
-CategorizedRepository<T, enlarge_factor, max_size>::item(
-		const address_t n) const
+template<class T, class GrowthPolicy>
+inline typename CategorizedRepository<T, GrowthPolicy>::const_reference
+CategorizedRepository<T, GrowthPolicy>::item(
+		const category_t cat, const address_t n) const
 {
-	assert(n < N_);
-	assert(valid(ids_[n]));
-	return items_[ids_[n]];
+	return items_[id(cat, n)];
 }
 
-template<class T, unsigned int enlarge_factor, unsigned int max_size>
-inline typename CategorizedRepository<T, enlarge_factor, max_size>::reference
-CategorizedRepository<T, enlarge_factor, max_size>::item(
-		const category_t cat, const address_t n)
+template<class T, class GrowthPolicy>
+inline id_t CategorizedRepository<T, GrowthPolicy>::id(
+		const address_t n) const
 {
-	assert(cat < C_);
-	assert(n < count_[cat]);
-	assert(valid(ids_[offset_[cat] + n]));
-	return items_[ids_[offset_[cat] + n]];
+	assert(n < nStored_);
+	address_t na = n;
+	const category_t cat = findCategory(na);
+	return ids_[cat][na];
 }
 
-template<class T, unsigned int enlarge_factor, unsigned int max_size>
-inline typename CategorizedRepository<T, enlarge_factor, max_size>::const_reference
-CategorizedRepository<T, enlarge_factor, max_size>::item(
+template<class T, class GrowthPolicy>
+inline id_t CategorizedRepository<T, GrowthPolicy>::id(
 		const category_t cat, const address_t n) const
 {
 	assert(cat < C_);
-	assert(n < count_[cat]);
-	assert(valid(ids_[offset_[cat] + n]));
-	return items_[ids_[offset_[cat] + n]];
+	assert(n < ids_[cat].size());
+	return ids_[cat][n];
 }
 
-template<class T, unsigned int enlarge_factor, unsigned int max_size>
-inline id_t CategorizedRepository<T, enlarge_factor, max_size>::id(
+template<class T, class GrowthPolicy>
+inline id_t CategorizedRepository<T, GrowthPolicy>::id(const group_t g,
 		const address_t n) const
 {
-	assert(n < N_);
-	return ids_[n];
+	return groupID(g, n);
 }
 
-template<class T, unsigned int enlarge_factor, unsigned int max_size>
-inline id_t CategorizedRepository<T, enlarge_factor, max_size>::id(
-		const category_t cat, const address_t n) const
+template<class T, class GrowthPolicy>
+inline id_t CategorizedRepository<T, GrowthPolicy>::freeID()
+{
+	if (ids_[C_].empty())
+	{
+		if (!enlarge())
+		throw(RepoAllocException());
+	}
+	return ids_[C_].back();
+}
+
+template<class T, class GrowthPolicy>
+inline void CategorizedRepository<T, GrowthPolicy>::store(const id_t uid,
+		const category_t cat)
+{
+	assert(cat < C_);
+	moveToCategory(uid, cat); // Move into right class
+	++nStored_;
+	updateMinMaxID(uid);
+}
+
+template<class T, class GrowthPolicy>
+id_t CategorizedRepository<T, GrowthPolicy>::insert(const T& itm,
+		const category_t cat)
 {
 	assert(cat < C_);
-	assert(offset_[cat] + n < N_);
-	assert(n < count_[cat]);
-	return ids_[offset_[cat] + n];
+	// Basic storage at the first free ID
+	const id_t uid = freeID();
+	items_[uid] = itm; // Store copy of item
+	store(uid, cat);
+	return uid;
 }
 
-template<class T, unsigned int enlarge_factor, unsigned int max_size>
-id_t CategorizedRepository<T, enlarge_factor, max_size>::insert(const T itm,
+#if __cplusplus >= 201103L
+template<class T, class GrowthPolicy>
+id_t CategorizedRepository<T, GrowthPolicy>::insert(T&& itm,
 		const category_t cat)
 {
 	assert(cat < C_);
-	// Basic storage at the end
-	address_t curnum = offset_[C_];
-	if (curnum >= N_)
+	const id_t uid = freeID();
+	items_[uid] = std::move(itm);
+	store(uid, cat);
+	return uid;
+}
+
+template<class T, class GrowthPolicy>
+id_t CategorizedRepository<T, GrowthPolicy>::insert(T&& itm)
+{
+	return insert(std::move(itm), 0);
+}
+
+template<class T, class GrowthPolicy>
+template<class... Args>
+id_t CategorizedRepository<T, GrowthPolicy>::emplace(const category_t cat,
+		Args&&... args)
+{
+	assert(cat < C_);
+	const id_t uid = freeID();
+	emplaceItem(items_[uid], std::forward<Args>(args)...);
+	store(uid, cat);
+	return uid;
+}
+#endif
+
+template<class T, class GrowthPolicy>
+template<class InputIterator, class CatIterator, class OutputIterator>
+OutputIterator CategorizedRepository<T, GrowthPolicy>::insertBulk(
+		InputIterator first, InputIterator last, CatIterator cats,
+		OutputIterator ids)
+{
+	const address_t n = std::distance(first, last);
+	if (n == 0)
+		return ids;
+	if (ids_[C_].size() < n)
 	{
-		if (!enlarge())
+		if (!enlarge(n))
 		throw(RepoAllocException());
 	}
-	id_t uid = ids_[curnum];
-	items_[uid] = itm; // Store copy of item
-	decreaseCat(curnum, cat); // Move into right class
-	++nStored_;
-	updateMinMaxID(uid);
-	return uid;
+
+	// counting pass, so that each category's ID list is allocated only once
+	std::vector<address_t> counts(C_, 0);
+	CatIterator c = cats;
+	for (address_t i = 0; i < n; ++i, ++c)
+	{
+		assert(*c < C_);
+		++counts[*c];
+	}
+	for (category_t i = 0; i < C_; ++i)
+	{
+		if (counts[i] > 0)
+			ids_[i].reserve(ids_[i].size() + counts[i]);
+	}
+
+	for (; first != last; ++first, ++cats, ++ids)
+	{
+		const id_t uid = ids_[C_].back();
+		items_[uid] = *first;
+		moveToCategoryUncounted(uid, *cats);
+		++nStored_;
+		updateMinMaxID(uid);
+		*ids = uid;
+	}
+	rebuildCountTree();
+	return ids;
 }
 
-template<class T, unsigned int enlarge_factor, unsigned int max_size>
-id_t CategorizedRepository<T, enlarge_factor, max_size>::insert(const T itm)
+template<class T, class GrowthPolicy>
+template<class IDIterator, class CatIterator>
+void CategorizedRepository<T, GrowthPolicy>::setCategories(IDIterator first,
+		const IDIterator last, CatIterator cats)
+{
+	for (; first != last; ++first, ++cats)
+	{
+		assert(valid(*first));
+		assert(*cats < C_);
+		moveToCategoryUncounted(*first, *cats);
+	}
+	rebuildCountTree();
+}
+
+template<class T, class GrowthPolicy>
+id_t CategorizedRepository<T, GrowthPolicy>::insert(const T& itm)
 {
 	return insert(itm, 0);
 }
 
-template<class T, unsigned int enlarge_factor, unsigned int max_size>
-CategorizedRepository<T, enlarge_factor, max_size>& CategorizedRepository<T,
-enlarge_factor, max_size>::operator<<(const T itm)
+template<class T, class GrowthPolicy>
+CategorizedRepository<T, GrowthPolicy>& CategorizedRepository<T, GrowthPolicy>::operator<<(const T& itm)
 {
 	insert(itm, 0);
 	return *this;
 }
 
-template<class T, unsigned int enlarge_factor, unsigned int max_size>
-void CategorizedRepository<T, enlarge_factor, max_size>::remove(const id_t id)
+template<class T, class GrowthPolicy>
+void CategorizedRepository<T, GrowthPolicy>::remove(const id_t id)
 {
 	assert(id < N_);
 	assert(valid(id));
-	return remove(nums_[id]);
-}
-
-template<class T, unsigned int enlarge_factor, unsigned int max_size>
-void CategorizedRepository<T, enlarge_factor, max_size>::remove(
-		const address_t n)
-{
-	assert(n < N_);
-	assert(n < nStored_);
-	id_t uid = ids_[n];
-	items_[ids_[n]] = T(); // set to default-constructed item; thus, IDs remain unique and unchanged
-	increaseCat(n, C_); // move to hidden category
+	resetItem(items_[id]); // clear item in place; thus, IDs remain unique and unchanged
+	moveToCategory(id, C_); // move to hidden category
 	--nStored_;
-	if (uid == minID_)
+	if (id == minID_)
 	updateMinID();
-	if (uid == maxID_)
+	if (id == maxID_)
 	updateMaxID();
 }
 
-template<class T, unsigned int enlarge_factor, unsigned int max_size>
-void CategorizedRepository<T, enlarge_factor, max_size>::removeAll()
+template<class T, class GrowthPolicy>
+void CategorizedRepository<T, GrowthPolicy>::remove(
+		const category_t cat, const address_t n)
+{
+	remove(id(cat, n));
+}
+
+template<class T, class GrowthPolicy>
+void CategorizedRepository<T, GrowthPolicy>::removeAll()
 {
 	clear();
 }
 
-template<class T, unsigned int enlarge_factor, unsigned int max_size>
-IndexIterator CategorizedRepository<T, enlarge_factor, max_size>::begin() const
+template<class T, class GrowthPolicy>
+IndexIterator CategorizedRepository<T, GrowthPolicy>::begin() const
 {
 	return IndexIterator(*this, minID_);
 }
 
-template<class T, unsigned int enlarge_factor, unsigned int max_size>
-IndexIterator CategorizedRepository<T, enlarge_factor, max_size>::end() const
+template<class T, class GrowthPolicy>
+IndexIterator CategorizedRepository<T, GrowthPolicy>::end() const
 {
 	if (nStored_ > 0)
 	return IndexIterator(*this, maxID_ + 1);
@@ -723,22 +824,22 @@ IndexIterator CategorizedRepository<T, enlarge_factor, max_size>::end() const
 	return IndexIterator(*this, maxID_);
 }
 
-template<class T, unsigned int enlarge_factor, unsigned int max_size> IndexIteratorRange
-CategorizedRepository<T, enlarge_factor, max_size>::ids() const
+template<class T, class GrowthPolicy> IndexIteratorRange
+CategorizedRepository<T, GrowthPolicy>::ids() const
 {
 	return std::make_pair(begin(), end());
 }
 
-template<class T, unsigned int enlarge_factor, unsigned int max_size> CategoryIteratorRange
-CategorizedRepository<T, enlarge_factor, max_size>::ids(
+template<class T, class GrowthPolicy> CategoryIteratorRange
+CategorizedRepository<T, GrowthPolicy>::ids(
 		const category_t cat) const
 {
 	assert(cat < C_);
 	/*
 	 * This is safe, because any empty items are guaranteed to be put in the
-	 * private category C_. See increaseCat() and decreaseCat().
+	 * private category C_. See remove().
 	 */
-	return std::make_pair( CategoryIterator(*this, cat), CategoryIterator(*this, cat, count_[cat])
+	return std::make_pair( CategoryIterator(*this, cat), CategoryIterator(*this, cat, ids_[cat].size())
 	);
 }
 
@@ -0,0 +1,88 @@
+/**
+ * This work is licensed under the Creative Commons
+ * Attribution-NonCommercial 3.0 Unported License. To view a copy of this
+ * license, visit http://creativecommons.org/licenses/by-nc/3.0/ or send a
+ * letter to Creative Commons, 444 Castro Street, Suite 900, Mountain View,
+ * California, 94041, USA.
+ */
+/**
+ * @file growth.h
+ * Growth policies for repo::CategorizedRepository.
+ *
+ * A growth policy is a class with a static member function
+ * @code
+ * static address_t newCapacity(address_t current);
+ * @endcode
+ * that returns the capacity a full repository of capacity @p current should be
+ * enlarged to. Returning a value not larger than @p current means that the
+ * repository cannot grow automatically; inserting into a full repository then
+ * throws a CategorizedRepository::RepoAllocException.
+ */
+#ifndef REPO_GROWTH_H_
+#define REPO_GROWTH_H_
+
+#include <largenet/base/repo/types.h>
+#include <limits>
+
+namespace repo
+{
+
+/**
+ * Geometric growth by a factor of @p num / @p den.
+ *
+ * Each time the repository is full, its capacity is multiplied by
+ * @p num / @p den (with @p num > @p den), but it never exceeds @p max_size. A
+ * @p max_size of zero means that growth is only limited by the range of
+ * @c address_t.
+ */
+template<unsigned int num, unsigned int den = 1, address_t max_size = 0>
+struct GeometricGrowth
+{
+	static address_t newCapacity(const address_t current)
+	{
+		const address_t limit = (max_size > 0) ? max_size
+				: std::numeric_limits<address_t>::max();
+		if (current >= limit)
+			return current;
+		if (current == 0)
+			return (num > 10) ? num : 10;
+		const address_t q = current / den;
+		const address_t rest = current % den * num / den;
+		if (q > limit / num)
+			return limit;
+		address_t newsize = q * num;
+		if (newsize > limit - rest)
+			return limit;
+		newsize += rest;
+		return (newsize > current) ? newsize : current + 1;
+	}
+};
+
+/**
+ * Growth policy of earlier versions of the library: enlarge by a factor of
+ * @p enlarge_factor up to at most @p max_size items.
+ */
+template<unsigned int enlarge_factor = 10, address_t max_size = 100000000>
+struct LegacyGrowth: public GeometricGrowth<enlarge_factor, 1, max_size>
+{
+};
+
+/**
+ * Never grow automatically. Capacity must be set up front, either in the
+ * constructor or by calling CategorizedRepository::reserve(). Useful for very
+ * large repositories, where an unexpected reallocation would temporarily need
+ * twice the memory.
+ */
+struct ReserveOnlyGrowth
+{
+	static address_t newCapacity(const address_t current)
+	{
+		return current;
+	}
+};
+
+typedef GeometricGrowth<2> DefaultGrowth; ///< Growth policy used if none is given.
+
+}
+
+#endif /* REPO_GROWTH_H_ */
@@ -70,13 +70,13 @@ public:
 	 * @param it Iterator to compare with.
 	 * @return True if equal.
 	 */
-	bool operator==(const IndexIterator& it);
+	bool operator==(const IndexIterator& it) const;
 	/**
 	 * Inequality operator.
 	 * @param it Iterator to compare with.
 	 * @return True if unequal.
 	 */
-	bool operator!=(const IndexIterator& it);
+	bool operator!=(const IndexIterator& it) const;
 	/**
 	 * Prefix increment operator.
 	 * @return Reference to (incremented) self.
@@ -104,8 +104,14 @@ private:
  * always dereference to the unique ID of an item actually stored in the repository.
  * Note that in addition to insertion into the repository, <b>changing an item's category
  * invalidates this iterator</b>, too.
+ *
+ * Since the IDs of a category are stored contiguously, this is a random access
+ * iterator, so that e.g. @c std::distance and @c std::advance take constant
+ * time and a category range can be split into parts. See also
+ * _Repo_base::idSpan().
  */
-class CategoryIterator: public std::iterator<std::input_iterator_tag, id_t>
+class CategoryIterator: public std::iterator<std::random_access_iterator_tag,
+		id_t, std::ptrdiff_t, const id_t*, const id_t&>
 {
 public:
 	/**
@@ -149,13 +155,37 @@ public:
 	 * @param it Iterator to compare with.
 	 * @return True if equal.
 	 */
-	bool operator==(const CategoryIterator& it);
+	bool operator==(const CategoryIterator& it) const;
 	/**
 	 * Inequality operator.
 	 * @param it Iterator to compare with.
 	 * @return True if unequal.
 	 */
-	bool operator!=(const CategoryIterator& it);
+	bool operator!=(const CategoryIterator& it) const;
+	/**
+	 * Less-than operator. Both iterators must traverse the same category.
+	 * @param it Iterator to compare with.
+	 * @return True if this iterator points to an item before @p it.
+	 */
+	bool operator<(const CategoryIterator& it) const;
+	/**
+	 * Greater-than operator.
+	 * @param it Iterator to compare with.
+	 * @return True if this iterator points to an item after @p it.
+	 */
+	bool operator>(const CategoryIterator& it) const;
+	/**
+	 * Less-or-equal operator.
+	 * @param it Iterator to compare with.
+	 * @return True if this iterator does not point to an item after @p it.
+	 */
+	bool operator<=(const CategoryIterator& it) const;
+	/**
+	 * Greater-or-equal operator.
+	 * @param it Iterator to compare with.
+	 * @return True if this iterator does not point to an item before @p it.
+	 */
+	bool operator>=(const CategoryIterator& it) const;
 	/**
 	 * Prefix increment operator.
 	 * @return Reference to (incremented) self.
@@ -166,15 +196,61 @@ public:
 	 * @return Copy of self before increment.
 	 */
 	CategoryIterator operator++(int);
+	/**
+	 * Prefix decrement operator.
+	 * @return Reference to (decremented) self.
+	 */
+	CategoryIterator& operator--();
+	/**
+	 * Postfix decrement operator.
+	 * @return Copy of self before decrement.
+	 */
+	CategoryIterator operator--(int);
+	/**
+	 * Advance iterator by @p n items.
+	 * @param n Number of items (may be negative).
+	 * @return Reference to self.
+	 */
+	CategoryIterator& operator+=(difference_type n);
+	/**
+	 * Move iterator back by @p n items.
+	 * @param n Number of items (may be negative).
+	 * @return Reference to self.
+	 */
+	CategoryIterator& operator-=(difference_type n);
+	/**
+	 * Return iterator advanced by @p n items.
+	 * @param n Number of items (may be negative).
+	 * @return Advanced iterator.
+	 */
+	CategoryIterator operator+(difference_type n) const;
+	/**
+	 * Return iterator moved back by @p n items.
+	 * @param n Number of items (may be negative).
+	 * @return Moved iterator.
+	 */
+	CategoryIterator operator-(difference_type n) const;
+	/**
+	 * Distance operator. Both iterators must traverse the same category.
+	 * @param it Iterator to subtract.
+	 * @return Number of items between @p it and this iterator.
+	 */
+	difference_type operator-(const CategoryIterator& it) const;
 	/**
 	 * Dereference operator.
 	 * @return Reference to item.
 	 */
-	id_t operator*();
+	const id_t& operator*() const;
+	/**
+	 * Subscript operator.
+	 * @param n Offset from current position.
+	 * @return Reference to the ID @p n items after the current one.
+	 */
+	const id_t& operator[](difference_type n) const;
 private:
 	const _Repo_base* rep_; ///< Repository the iterator belongs to.
 	category_t category_; ///< Category the iterator traverses.
-	address_t cur_; ///< Current iterator position, relative to rep_->offset_[category_] (index in ids_ array).
+	address_t cur_; ///< Current iterator position, index in the category's ids_ vector.
 }; // class _Repo_base::CategoryIterator
 
 
@@ -219,12 +295,12 @@ inline IndexIterator& IndexIterator::operator=(const IndexIterator& it)
 	return *this;
 }
 
-inline bool IndexIterator::operator==(const IndexIterator& it)
+inline bool IndexIterator::operator==(const IndexIterator& it) const
 {
 	return ((rep_ == it.rep_) && (cur_ == it.cur_));
 }
 
-inline bool IndexIterator::operator!=(const IndexIterator& it)
+inline bool IndexIterator::operator!=(const IndexIterator& it) const
 {
 	return !this->operator==(it);
 }
@@ -282,7 +358,7 @@ inline CategoryIterator::CategoryIterator(const _Repo_base& repo,
 {
 	assert(&repo != NULL);
 	assert(cat < repo.C_);
-	assert(n <= repo.count_[cat]); // equal on end()
+	assert(n <= repo.ids_[cat].size()); // equal on end()
 }
 
 inline CategoryIterator::CategoryIterator(const CategoryIterator& it) :
@@ -302,17 +378,38 @@ inline CategoryIterator& CategoryIterator::operator=(const CategoryIterator& it)
 	return *this;
 }
 
-inline bool CategoryIterator::operator==(const CategoryIterator& it)
+inline bool CategoryIterator::operator==(const CategoryIterator& it) const
 {
 	return ((rep_ == it.rep_) && (category_ == it.category_) && (cur_
 			== it.cur_));
 }
 
-inline bool CategoryIterator::operator!=(const CategoryIterator& it)
+inline bool CategoryIterator::operator!=(const CategoryIterator& it) const
 {
 	return !this->operator==(it);
 }
 
+inline bool CategoryIterator::operator<(const CategoryIterator& it) const
+{
+	assert((rep_ == it.rep_) && (category_ == it.category_));
+	return cur_ < it.cur_;
+}
+
+inline bool CategoryIterator::operator>(const CategoryIterator& it) const
+{
+	return it < *this;
+}
+
+inline bool CategoryIterator::operator<=(const CategoryIterator& it) const
+{
+	return !(it < *this);
+}
+
+inline bool CategoryIterator::operator>=(const CategoryIterator& it) const
+{
+	return !(*this < it);
+}
+
 inline CategoryIterator& CategoryIterator::operator++()
 {
 	assert(rep_ != NULL);
@@ -331,12 +428,71 @@ inline CategoryIterator CategoryIterator::operator++(int)
 	return (tmp);
 }
 
-inline id_t CategoryIterator::operator*()
+inline CategoryIterator& CategoryIterator::operator--()
+{
+	assert(rep_ != NULL);
+	assert(cur_ > 0);
+	--cur_;
+	return *this;
+}
+
+inline CategoryIterator CategoryIterator::operator--(int)
+{
+	CategoryIterator tmp(*this);
+	--(*this);
+	return (tmp);
+}
+
+inline CategoryIterator& CategoryIterator::operator+=(const difference_type n)
+{
+	assert(rep_ != NULL);
+	cur_ = static_cast<address_t>(cur_ + n);
+	assert(cur_ <= rep_->ids_[category_].size());
+	return *this;
+}
+
+inline CategoryIterator& CategoryIterator::operator-=(const difference_type n)
+{
+	return *this += -n;
+}
+
+inline CategoryIterator CategoryIterator::operator+(const difference_type n) const
+{
+	CategoryIterator tmp(*this);
+	return tmp += n;
+}
+
+inline CategoryIterator CategoryIterator::operator-(const difference_type n) const
+{
+	CategoryIterator tmp(*this);
+	return tmp -= n;
+}
+
+inline CategoryIterator::difference_type CategoryIterator::operator-(
+		const CategoryIterator& it) const
+{
+	assert((rep_ == it.rep_) && (category_ == it.category_));
+	return static_cast<difference_type>(cur_)
+			- static_cast<difference_type>(it.cur_);
+}
+
+inline const id_t& CategoryIterator::operator*() const
 {
 	assert(rep_ != NULL);
 	// this should be correct now
-	assert(cur_ < rep_->count_[category_]);
-	return rep_->ids_[cur_ + rep_->offset_[category_]];
+	assert(cur_ < rep_->ids_[category_].size());
+	return rep_->ids_[category_][cur_];
+}
+
+inline const id_t& CategoryIterator::operator[](const difference_type n) const
+{
+	return *(*this + n);
+}
+
+inline CategoryIterator operator+(const CategoryIterator::difference_type n,
+		const CategoryIterator& it)
+{
+	return it + n;
 }
 
 }
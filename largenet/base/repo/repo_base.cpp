@@ -23,24 +23,25 @@ _Repo_base::_Repo_base() :
 }
 
 _Repo_base::_Repo_base(category_t cat) :
-	C_(cat), N_(100), nStored_(0), count_(cat + 1, 0), offset_(cat + 1, 0),
-			nums_(N_, 0), ids_(N_, 0), minID_(0), maxID_(0)
+	C_(cat), N_(100), nStored_(0), minID_(0), maxID_(0)
 {
 	assert(C_ > 0);
 	_init();
 }
 
 _Repo_base::_Repo_base(const category_t cat, const id_size_t n) :
-	C_(cat), N_(n), nStored_(0), count_(cat + 1, 0), offset_(cat + 1, 0),
-			nums_(N_, 0), ids_(N_, 0), minID_(0), maxID_(0)
+	C_(cat), N_(n), nStored_(0), minID_(0), maxID_(0)
 {
 	_init();
 }
 
 _Repo_base::_Repo_base(const _Repo_base& r) :
-	C_(r.C_), N_(r.nStored_), count_(C_ + 1, 0), offset_(C_ + 1, 0)
+	C_(r.C_), N_(r.N_), nStored_(r.nStored_), ids_(r.ids_), nums_(r.nums_),
+			cats_(r.cats_), countTree_(r.countTree_),
+			occupied_(r.occupied_), minID_(r.minID_), maxID_(r.maxID_),
+			groups_(r.groups_), memberOf_(r.memberOf_), weights_(r.weights_),
+			weightTrees_(r.weightTrees_)
 {
-	_init();
 }
 
 _Repo_base::~_Repo_base()
@@ -50,28 +51,176 @@ _Repo_base::~_Repo_base()
 void _Repo_base::_init()
 {
 	nStored_ = 0;
-	nums_.reserve(N_);
+	ids_.clear();
+	ids_.resize(C_ + 1);
 	nums_.resize(N_, 0);
-	ids_.reserve(N_);
-	ids_.resize(N_, 0);
-	count_.reserve(C_ + 1);
-	count_.resize(C_ + 1, 0);
-	offset_.reserve(C_ + 1);
-	offset_.resize(C_ + 1, 0);
-	for (unsigned int i = 0; i < N_; ++i)
+	cats_.assign(N_, C_);
+	// free IDs are handed out from the back, lowest first
+	id_vector& free = ids_[C_];
+	free.reserve(N_);
+	for (address_t i = 0; i < N_; ++i)
+	{
+		free.push_back(N_ - 1 - i);
+		nums_[N_ - 1 - i] = i;
+	}
+	countTree_.assign(C_ + 1, 0);
+	rebuildOccupancy();
+	minID_ = 0;
+	maxID_ = 0;
+	rebuildGroupCounts();
+	if (hasWeights())
 	{
-		ids_[i] = i;
-		nums_[i] = i;
+		weights_.assign(N_, 1.0);
+		rebuildWeightTrees();
 	}
-	for (unsigned int i = 0; i < C_; ++i)
+}
+
+void _Repo_base::setWeight(const id_t id, const double w)
+{
+	assert(id < N_);
+	assert(w >= 0);
+	if (!hasWeights())
 	{
-		count_[i] = 0;
-		offset_[i] = 0;
+		weights_.assign(N_, 1.0);
+		rebuildWeightTrees();
 	}
-	offset_[C_] = 0;
-	count_[C_] = N_;
+	if (cats_[id] < C_)
+		addToWeightTree(weightTrees_[cats_[id]], nums_[id], w - weights_[id]);
+	weights_[id] = w;
+}
+
+void _Repo_base::rebuildWeightTrees()
+{
+	weightTrees_.clear();
+	if (!hasWeights())
+		return;
+	weightTrees_.resize(C_);
+	for (category_t c = 0; c < C_; ++c)
+	{
+		std::vector<double>& tree = weightTrees_[c];
+		tree.reserve(ids_[c].size() + 1);
+		tree.push_back(0);
+		for (id_vector::const_iterator it = ids_[c].begin(); it
+				!= ids_[c].end(); ++it)
+			appendToWeightTree(tree, weights_[*it]);
+	}
+}
+
+void _Repo_base::compactIDs(std::vector<id_t>& map)
+{
+	map.assign(N_, INVALID_ID);
+	id_t next = 0;
+	for (id_t i = 0; i < N_; ++i)
+	{
+		if (cats_[i] < C_)
+		{
+			// new IDs never exceed old ones, so this works in place
+			map[i] = next;
+			nums_[next] = nums_[i];
+			cats_[next] = cats_[i];
+			if (hasWeights())
+				weights_[next] = weights_[i];
+			++next;
+		}
+	}
+	assert(next == nStored_);
+	for (category_t c = 0; c < C_; ++c)
+	{
+		for (id_vector::iterator it = ids_[c].begin(); it != ids_[c].end(); ++it)
+			*it = map[*it];
+	}
+	// free IDs above the stored ones, lowest on top
+	id_vector& free = ids_[C_];
+	free.clear();
+	for (address_t i = N_; i > nStored_; --i)
+	{
+		nums_[i - 1] = free.size();
+		cats_[i - 1] = C_;
+		free.push_back(i - 1);
+	}
+	rebuildOccupancy();
 	minID_ = 0;
-	maxID_ = 0;
+	maxID_ = (nStored_ > 0) ? nStored_ - 1 : 0;
+}
+
+void _Repo_base::rebuildOccupancy()
+{
+	const address_t n = cats_.size();
+	occupied_.assign(1, std::vector<word_t>((n + wordBits_ - 1) / wordBits_, 0));
+	for (id_t i = 0; i < n; ++i)
+	{
+		if (cats_[i] < C_)
+			occupied_[0][i / wordBits_] |= static_cast<word_t>(1) << (i
+					% wordBits_);
+	}
+	while (occupied_.back().size() > 1)
+	{
+		const std::vector<word_t>& below = occupied_.back();
+		std::vector<word_t> level((below.size() + wordBits_ - 1) / wordBits_, 0);
+		for (address_t i = 0; i < below.size(); ++i)
+		{
+			if (below[i] != 0)
+				level[i / wordBits_] |= static_cast<word_t>(1) << (i
+						% wordBits_);
+		}
+		occupied_.push_back(std::vector<word_t>());
+		occupied_.back().swap(level);
+	}
+}
+
+void _Repo_base::rebuildCountTree()
+{
+	countTree_.assign(C_ + 1, 0);
+	for (category_t i = 1; i <= C_; ++i)
+	{
+		countTree_[i] += ids_[i - 1].size();
+		const category_t parent = i + (i & (~i + 1));
+		if (parent <= C_)
+			countTree_[parent] += countTree_[i];
+	}
+	rebuildGroupCounts();
+}
+
+void _Repo_base::rebuildGroupMembership()
+{
+	memberOf_.clear();
+	if (groups_.empty())
+		return;
+	memberOf_.resize(C_ + 1);
+	for (unsigned int g = 0; g < groups_.size(); ++g)
+	{
+		std::vector<category_t> cats;
+		cats.swap(groups_[g].cats);
+		for (std::vector<category_t>::const_iterator c = cats.begin(); c
+				!= cats.end(); ++c)
+		{
+			if (*c < C_)
+			{
+				memberOf_[*c].push_back(std::make_pair(g,
+						static_cast<category_t>(groups_[g].cats.size())));
+				groups_[g].cats.push_back(*c);
+			}
+		}
+	}
+}
+
+void _Repo_base::rebuildGroupCounts()
+{
+	for (std::vector<CategoryGroup>::iterator g = groups_.begin(); g
+			!= groups_.end(); ++g)
+	{
+		const category_t size = g->cats.size();
+		g->tree.assign(size + 1, 0);
+		g->count = 0;
+		for (category_t i = 1; i <= size; ++i)
+		{
+			g->tree[i] += ids_[g->cats[i - 1]].size();
+			g->count += ids_[g->cats[i - 1]].size();
+			const category_t parent = i + (i & (~i + 1));
+			if (parent <= size)
+				g->tree[parent] += g->tree[i];
+		}
+	}
 }
 
 }
@@ -16,6 +16,10 @@
 
 #include <largenet/base/repo/types.h>
 #include <vector>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <climits>
 #include <cassert>
 
 namespace repo
@@ -24,6 +28,12 @@ namespace repo
 class IndexIterator;
 class CategoryIterator;
 
+/**
+ * Contiguous, read-only range of item IDs, given as a pair of pointers to the
+ * first ID and past the last ID. Empty ranges are (NULL, NULL).
+ */
+typedef std::pair<const id_t*, const id_t*> IDSpan;
+
 class _Repo_base
 {
 	friend class IndexIterator;
@@ -51,6 +61,81 @@ public:
 	 * @return Number of items in category @p cat
 	 */
 	id_size_t count(category_t cat) const;
+	/**
+	 * Return the IDs of all items in category @p cat as a contiguous range,
+	 * without copying. The order is the same as that of a CategoryIterator
+	 * traversal. Like iterators, the range is invalidated by inserting or
+	 * removing items and by changing categories.
+	 * @param cat Category.
+	 * @return Pointers to the first and past the last ID in category @p cat.
+	 */
+	IDSpan idSpan(category_t cat) const;
+
+	/**
+	 * Register a group of categories, whose total number of items is kept up
+	 * to date as items are inserted, removed, or change category. Counting or
+	 * drawing items from a group then no longer requires summing over its
+	 * categories. Each category may appear at most once in a group, but may
+	 * belong to several groups.
+	 * @param first Iterator to first category of the group.
+	 * @param last Iterator past the last category of the group.
+	 * @return Handle of the new group.
+	 */
+	template<class InputIterator>
+	group_t addGroup(InputIterator first, InputIterator last);
+	/**
+	 * Return number of registered category groups.
+	 * @return Number of groups.
+	 */
+	unsigned int numberOfGroups() const;
+	/**
+	 * Return number of items in any category of group @p g. This takes
+	 * constant time.
+	 * @param g Category group.
+	 * @return Number of items in group @p g.
+	 * @throw std::out_of_range if @p g is not a registered group, e.g. because
+	 * the groups have been dropped by a reset since @p g was registered.
+	 */
+	id_size_t count(group_t g) const;
+
+	/**
+	 * Check if items carry individual weights. Weights are switched on by the
+	 * first call to setWeight(); until then, every item has weight 1.
+	 * @return True if setWeight() has been called.
+	 */
+	bool hasWeights() const;
+	/**
+	 * Return weight of item with ID @p id.
+	 * @param id Unique ID of item.
+	 * @return Weight of item, 1 if weights are not in use.
+	 */
+	double weight(id_t id) const;
+	/**
+	 * Set weight of item with ID @p id, e.g. its individual event rate. Items
+	 * keep their weight when changing category, and newly inserted items have
+	 * weight 1. The first call takes time linear in the number of items to
+	 * set up the weight trees, later calls take logarithmic time.
+	 * @param id Unique ID of item.
+	 * @param w Non-negative weight.
+	 */
+	void setWeight(id_t id, double w);
+	/**
+	 * Return total weight of all items in category @p cat. Without weights,
+	 * this is the number of items in @p cat.
+	 * @param cat Category.
+	 * @return Sum of item weights in @p cat.
+	 */
+	double totalWeight(category_t cat) const;
+	/**
+	 * Return ID of the item in category @p cat at which the cumulative weight
+	 * of the category's items exceeds @p x. Drawing @p x uniformly from
+	 * [0, totalWeight(cat)) picks an item with probability proportional to its
+	 * weight. This takes time logarithmic in the number of items in @p cat.
+	 * @param cat Category, must not be empty.
+	 * @param x Cumulative weight.
+	 * @return Unique ID of item.
+	 */
+	id_t idByWeight(category_t cat, double x) const;
 
 	/**
 	 * Return current maximum number of storable items, i.e. reserved memory.
@@ -74,8 +159,19 @@ public:
 	id_t minID() const;
 
 protected:
+	typedef std::vector<id_t> id_vector; ///< List of item IDs in one category.
+
 	void _init();
+	/**
+	 * Find the smallest valid ID, assuming that there is none below the
+	 * current minID_ (e.g. after removing the item with that ID). This
+	 * searches the occupancy bitmap and takes time logarithmic in capacity.
+	 */
 	void updateMinID();
+	/**
+	 * Find the largest valid ID, assuming that there is none above the
+	 * current maxID_.
+	 */
 	void updateMaxID();
 	/**
 	 * Recalculate the minimum and maximum valid ID
@@ -88,20 +184,137 @@ protected:
 	 */
 	void updateMinMaxID(id_t id);
 
+	/**
+	 * Move item with ID @p id into category @p cat. The item is appended to
+	 * the ID list of @p cat, and the gap it leaves in its old category is
+	 * filled with that category's last ID. This takes constant time,
+	 * independent of the distance between the two categories.
+	 * @param id Unique ID of item.
+	 * @param cat Category to put item into (may be the hidden category @c C_).
+	 */
+	void moveToCategory(id_t id, category_t cat);
+	/**
+	 * Same as moveToCategory(), but leaves the per-category count tree and
+	 * the group counts untouched. Call rebuildCountTree() after a batch of
+	 * these.
+	 * @param id Unique ID of item.
+	 * @param cat Category to put item into (may be the hidden category @c C_).
+	 */
+	void moveToCategoryUncounted(id_t id, category_t cat);
+
+	/**
+	 * Find the category of the @p n 'th stored item, where items are numbered
+	 * consecutively by category. On return, @p n holds the item's number
+	 * within that category.
+	 * @param[in,out] n Number of item.
+	 * @return Category of item.
+	 */
+	category_t findCategory(address_t& n) const;
+	/**
+	 * Rebuild the per-category count tree and the group counts from the ID
+	 * lists.
+	 */
+	void rebuildCountTree();
+	/**
+	 * Renumber stored items with consecutive IDs starting at zero, keeping
+	 * their order and categories. Only the bookkeeping is updated; moving the
+	 * items themselves is up to the derived class.
+	 * @param[out] map Map from old to new IDs, with INVALID_ID for IDs not in use.
+	 */
+	void compactIDs(std::vector<id_t>& map);
+	/**
+	 * Rebuild the occupancy bitmap of valid IDs from the item categories,
+	 * e.g. after changing capacity.
+	 */
+	void rebuildOccupancy();
+	/**
+	 * Return the smallest valid ID not below @p id.
+	 * @param id Unique ID.
+	 * @return Valid ID, or INVALID_ID if there is none.
+	 */
+	id_t nextValid(id_t id) const;
+	/**
+	 * Return the largest valid ID not above @p id.
+	 * @param id Unique ID.
+	 * @return Valid ID, or INVALID_ID if there is none.
+	 */
+	id_t previousValid(id_t id) const;
+	/**
+	 * Return ID of the @p n 'th item in group @p g, where the items of a
+	 * group are numbered consecutively by category. This takes time
+	 * logarithmic in the size of the group.
+	 * @param g Category group.
+	 * @param n Number of item in group @p g.
+	 * @throw std::out_of_range if @p g is not a registered group.
+	 * @return Unique ID of item.
+	 */
+	id_t groupID(group_t g, address_t n) const;
+	/**
+	 * Recount the items in all category groups from the ID lists.
+	 */
+	void rebuildGroupCounts();
+	/**
+	 * Remove categories that no longer exist from all groups and rebuild the
+	 * per-category group membership, e.g. after changing the number of
+	 * categories. Does not recount.
+	 */
+	void rebuildGroupMembership();
+
+	/**
+	 * Recalculate the per-category weight trees from the item weights, if
+	 * weights are in use.
+	 */
+	void rebuildWeightTrees();
+
+	/**
+	 * A group of categories with its maintained item count.
+	 */
+	struct CategoryGroup
+	{
+		std::vector<category_t> cats; ///< categories in the group
+		std::vector<address_t> tree; ///< Fenwick tree of item counts per member category
+		address_t count; ///< total number of items in the group
+	};
+	/// Group and position within that group, for each group a category belongs to.
+	typedef std::vector<std::pair<unsigned int, category_t> > membership_vector;
+
 	category_t C_; ///< number of categories
 	address_t N_; ///< current max number of items
 	address_t nStored_; ///< total number of items stored
-	std::vector<address_t> count_; ///< number of items per category;
-	std::vector<address_t> offset_; ///< start index of a class
-	std::vector<address_t> nums_; ///< number of an item according to id
-	std::vector<id_t> ids_; ///< id of an item according to number
+	std::vector<id_vector> ids_; ///< ids of the items in each category, hidden category @c C_ holds free ids
+	std::vector<address_t> nums_; ///< number of an item in its category according to id
+	std::vector<category_t> cats_; ///< category of an item according to id
+	std::vector<address_t> countTree_; ///< Fenwick tree of category counts, for numbering items across categories
+	typedef unsigned long word_t; ///< Word of the occupancy bitmap.
+	static const unsigned int wordBits_ = sizeof(word_t) * CHAR_BIT; ///< number of IDs per bitmap word
+	/// Bitmap of valid IDs. Level 0 has one bit per ID, each further level
+	/// one bit per word of the level below, set if that word is non-zero.
+	/// The top level is a single word.
+	std::vector<std::vector<word_t> > occupied_;
 	id_t minID_; ///< smallest valid ID
 	id_t maxID_; ///< largest valid ID
+	std::vector<CategoryGroup> groups_; ///< registered category groups
+	std::vector<membership_vector> memberOf_; ///< groups each category belongs to, empty if there are no groups
+	std::vector<double> weights_; ///< weight of an item according to id, empty if weights are not in use
+	std::vector<std::vector<double> > weightTrees_; ///< Fenwick tree of item weights in each category, by number in category
+
+private:
+	const CategoryGroup& group(group_t g) const;
+	void markValid(id_t id);
+	void markInvalid(id_t id);
+	static unsigned int lowestBit(word_t w);
+	static unsigned int highestBit(word_t w);
+	void addToCountTree(category_t cat, long int delta);
+	void addToGroups(category_t cat, long int delta);
+	void moveWeight(id_t id, category_t from, category_t to);
+	static void addToWeightTree(std::vector<double>& tree, address_t n,
+			double delta);
+	static void appendToWeightTree(std::vector<double>& tree, double w);
 };
 
 inline bool _Repo_base::valid(const id_t i) const
 {
-	return ((nStored_ > 0) && (i < N_) && (nums_[i] < nStored_));
+	return ((nStored_ > 0) && (i < N_) && (cats_[i] < C_));
 }
 
 inline id_t _Repo_base::maxID() const
@@ -127,7 +340,172 @@ inline id_size_t _Repo_base::size() const
 inline id_size_t _Repo_base::count(const category_t cat) const
 {
 	assert(cat < C_);
-	return count_[cat];
+	return ids_[cat].size();
+}
+
+inline IDSpan _Repo_base::idSpan(const category_t cat) const
+{
+	assert(cat < C_);
+	const id_vector& v = ids_[cat];
+	if (v.empty())
+		return IDSpan(static_cast<const id_t*>(0), static_cast<const id_t*>(0));
+	return IDSpan(&v[0], &v[0] + v.size());
+}
+
+template<class InputIterator>
+group_t _Repo_base::addGroup(InputIterator first, InputIterator last)
+{
+	const group_t g(groups_.size());
+	groups_.push_back(CategoryGroup());
+	if (memberOf_.empty())
+		memberOf_.resize(C_ + 1);
+	CategoryGroup& grp = groups_.back();
+	for (; first != last; ++first)
+	{
+		const category_t c = *first;
+		assert(c < C_);
+		assert(std::find(grp.cats.begin(), grp.cats.end(), c) == grp.cats.end());
+		memberOf_[c].push_back(std::make_pair(g.index,
+				static_cast<category_t>(grp.cats.size())));
+		grp.cats.push_back(c);
+	}
+	rebuildGroupCounts();
+	return g;
+}
+
+inline unsigned int _Repo_base::numberOfGroups() const
+{
+	return groups_.size();
+}
+
+inline const _Repo_base::CategoryGroup& _Repo_base::group(const group_t g) const
+{
+	if (g.index >= groups_.size())
+		throw(std::out_of_range("Category group is not registered."));
+	return groups_[g.index];
+}
+
+inline id_size_t _Repo_base::count(const group_t g) const
+{
+	return group(g).count;
+}
+
+inline id_t _Repo_base::groupID(const group_t g, address_t n) const
+{
+	const CategoryGroup& grp = group(g);
+	assert(n < grp.count);
+	const category_t size = grp.cats.size();
+	category_t pos = 0, step = 1;
+	while (2 * step <= size)
+		step *= 2;
+	for (; step > 0; step /= 2)
+	{
+		if ((pos + step <= size) && (grp.tree[pos + step] <= n))
+		{
+			pos += step;
+			n -= grp.tree[pos];
+		}
+	}
+	return ids_[grp.cats[pos]][n];
+}
+
+inline void _Repo_base::addToGroups(const category_t cat, const long int delta)
+{
+	const membership_vector& m = memberOf_[cat];
+	for (membership_vector::const_iterator it = m.begin(); it != m.end(); ++it)
+	{
+		CategoryGroup& grp = groups_[it->first];
+		grp.count += delta;
+		const category_t size = grp.cats.size();
+		for (category_t i = it->second + 1; i <= size; i += i & (~i + 1))
+			grp.tree[i] += delta;
+	}
+}
+
+inline bool _Repo_base::hasWeights() const
+{
+	return !weights_.empty();
+}
+
+inline double _Repo_base::weight(const id_t id) const
+{
+	assert(id < N_);
+	return hasWeights() ? weights_[id] : 1.0;
+}
+
+inline double _Repo_base::totalWeight(const category_t cat) const
+{
+	assert(cat < C_);
+	if (!hasWeights())
+		return ids_[cat].size();
+	const std::vector<double>& tree = weightTrees_[cat];
+	double sum = 0;
+	for (address_t i = tree.size() - 1; i > 0; i -= i & (~i + 1))
+		sum += tree[i];
+	return sum;
+}
+
+inline id_t _Repo_base::idByWeight(const category_t cat, double x) const
+{
+	assert(cat < C_);
+	assert(!ids_[cat].empty());
+	const address_t size = ids_[cat].size();
+	if (!hasWeights())
+	{
+		const address_t n = (x > 0) ? static_cast<address_t>(x) : 0;
+		return ids_[cat][(n < size) ? n : size - 1];
+	}
+	const std::vector<double>& tree = weightTrees_[cat];
+	address_t pos = 0, step = 1;
+	while (2 * step <= size)
+		step *= 2;
+	for (; step > 0; step /= 2)
+	{
+		if ((pos + step <= size) && (tree[pos + step] <= x))
+		{
+			pos += step;
+			x -= tree[pos];
+		}
+	}
+	// x beyond the total weight, e.g. due to rounding
+	return ids_[cat][(pos < size) ? pos : size - 1];
+}
+
+inline void _Repo_base::addToWeightTree(std::vector<double>& tree,
+		const address_t n, const double delta)
+{
+	for (address_t i = n + 1; i < tree.size(); i += i & (~i + 1))
+		tree[i] += delta;
+}
+
+inline void _Repo_base::appendToWeightTree(std::vector<double>& tree,
+		const double w)
+{
+	// the new node sums up w and the nodes covering the preceding range
+	const address_t k = tree.size();
+	const address_t stop = k - (k & (~k + 1));
+	double sum = w;
+	for (address_t i = k - 1; i > stop; i -= i & (~i + 1))
+		sum += tree[i];
+	tree.push_back(sum);
+}
+
+inline void _Repo_base::moveWeight(const id_t id, const category_t from,
+		const category_t to)
+{
+	if (from < C_)
+	{
+		// the last item fills the gap, then the last node is dropped
+		std::vector<double>& tree = weightTrees_[from];
+		const id_t last = ids_[from].back();
+		if (last != id)
+			addToWeightTree(tree, nums_[id], weights_[last] - weights_[id]);
+		tree.pop_back();
+	}
+	else
+		weights_[id] = 1.0; // newly inserted item
+	if (to < C_)
+		appendToWeightTree(weightTrees_[to], weights_[id]);
 }
 
 inline address_t _Repo_base::capacity() const
@@ -140,39 +518,221 @@ inline category_t _Repo_base::numberOfCategories() const
 	return C_;
 }
 
-inline void _Repo_base::updateMinID()
+inline void _Repo_base::addToCountTree(const category_t cat, const long int delta)
 {
-	if (nStored_ > 0)
+	for (category_t i = cat + 1; i <= C_; i += i & (~i + 1))
+		countTree_[i] += delta;
+}
+
+inline void _Repo_base::moveToCategory(const id_t id, const category_t cat)
+{
+	assert(id < N_);
+	const category_t old = cats_[id];
+	if (old == cat)
+		return;
+	moveToCategoryUncounted(id, cat);
+	if (old < C_)
+		addToCountTree(old, -1);
+	if (cat < C_)
+		addToCountTree(cat, 1);
+	if (!groups_.empty())
 	{
-		minID_ = 0;
-		while (!valid(minID_) && (minID_ < N_))
-			++minID_;
+		addToGroups(old, -1);
+		addToGroups(cat, 1);
 	}
+}
+
+inline void _Repo_base::moveToCategoryUncounted(const id_t id,
+		const category_t cat)
+{
+	assert(id < N_);
+	assert(cat <= C_);
+	const category_t old = cats_[id];
+	if (old == cat)
+		return;
+	if (hasWeights())
+		moveWeight(id, old, cat);
+
+	// fill the gap in the old category with its last item
+	id_vector& from = ids_[old];
+	const id_t last = from.back();
+	from[nums_[id]] = last;
+	nums_[last] = nums_[id];
+	from.pop_back();
+	if ((from.capacity() > 1024) && (4 * from.size() < from.capacity()))
+		id_vector(from).swap(from); // give back memory after heavy churn
+
+	id_vector& to = ids_[cat];
+	nums_[id] = to.size();
+	to.push_back(id);
+	cats_[id] = cat;
+
+	if (old == C_)
+		markValid(id);
+	else if (cat == C_)
+		markInvalid(id);
+}
+
+inline void _Repo_base::markValid(id_t id)
+{
+	for (unsigned int k = 0; k < occupied_.size(); ++k)
+	{
+		word_t& w = occupied_[k][id / wordBits_];
+		const bool wasEmpty = (w == 0);
+		w |= static_cast<word_t>(1) << (id % wordBits_);
+		if (!wasEmpty)
+			return;
+		id /= wordBits_;
+	}
+}
+
+inline void _Repo_base::markInvalid(id_t id)
+{
+	for (unsigned int k = 0; k < occupied_.size(); ++k)
+	{
+		word_t& w = occupied_[k][id / wordBits_];
+		w &= ~(static_cast<word_t>(1) << (id % wordBits_));
+		if (w != 0)
+			return;
+		id /= wordBits_;
+	}
+}
+
+inline unsigned int _Repo_base::lowestBit(word_t w)
+{
+	assert(w != 0);
+#ifdef __GNUC__
+	return __builtin_ctzl(w);
+#else
+	unsigned int n = 0;
+	for (; (w & 1) == 0; w >>= 1)
+		++n;
+	return n;
+#endif
+}
+
+inline unsigned int _Repo_base::highestBit(word_t w)
+{
+	assert(w != 0);
+#ifdef __GNUC__
+	return wordBits_ - 1 - __builtin_clzl(w);
+#else
+	unsigned int n = 0;
+	while (w >>= 1)
+		++n;
+	return n;
+#endif
+}
+
+inline id_t _Repo_base::nextValid(id_t id) const
+{
+	// go up until a word has a set bit at or after the position, then down
+	unsigned int k = 0;
+	for (;; ++k)
+	{
+		if (k == occupied_.size())
+			return INVALID_ID;
+		const std::vector<word_t>& level = occupied_[k];
+		const address_t w = id / wordBits_;
+		if (w >= level.size())
+			return INVALID_ID;
+		const word_t bits = level[w] & (~static_cast<word_t>(0) << (id
+				% wordBits_));
+		if (bits != 0)
+		{
+			id = w * wordBits_ + lowestBit(bits);
+			break;
+		}
+		id = w + 1;
+	}
+	while (k > 0)
+	{
+		--k;
+		id = id * wordBits_ + lowestBit(occupied_[k][id]);
+	}
+	return id;
+}
+
+inline id_t _Repo_base::previousValid(id_t id) const
+{
+	unsigned int k = 0;
+	for (;; ++k)
+	{
+		if (k == occupied_.size())
+			return INVALID_ID;
+		const std::vector<word_t>& level = occupied_[k];
+		const address_t w = id / wordBits_;
+		assert(w < level.size());
+		const word_t bits = level[w] & (~static_cast<word_t>(0) >> (wordBits_
+				- 1 - id % wordBits_));
+		if (bits != 0)
+		{
+			id = w * wordBits_ + highestBit(bits);
+			break;
+		}
+		if (w == 0)
+			return INVALID_ID;
+		id = w - 1;
+	}
+	while (k > 0)
+	{
+		--k;
+		id = id * wordBits_ + highestBit(occupied_[k][id]);
+	}
+	return id;
+}
+
+inline category_t _Repo_base::findCategory(address_t& n) const
+{
+	assert(n < nStored_);
+	category_t pos = 0, step = 1;
+	while (2 * step <= C_)
+		step *= 2;
+	for (; step > 0; step /= 2)
+	{
+		if ((pos + step <= C_) && (countTree_[pos + step] <= n))
+		{
+			pos += step;
+			n -= countTree_[pos];
+		}
+	}
+	return pos;
+}
+
+inline void _Repo_base::updateMinID()
+{
+	if (nStored_ > 0)
+		minID_ = nextValid(minID_);
 	else
 		minID_ = 0;
+	assert(minID_ != INVALID_ID);
 }
 
 inline void _Repo_base::updateMaxID()
 {
 	if (nStored_ > 0)
-	{
-		maxID_ = N_ - 1;
-		while (!valid(maxID_) && (maxID_ > 0))
-			--maxID_;
-	}
+		maxID_ = previousValid(maxID_);
 	else
 		maxID_ = 0;
+	assert(maxID_ != INVALID_ID);
 }
 
 inline void _Repo_base::updateMinMaxID()
 {
+	minID_ = 0;
+	maxID_ = (N_ > 0) ? N_ - 1 : 0;
 	updateMinID();
 	updateMaxID();
 }
 
 inline void _Repo_base::updateMinMaxID(const id_t id)
 {
-	if (nStored_ > 0)
+	if (nStored_ == 1)
+	{
+		minID_ = id;
+		maxID_ = id;
+	}
+	else if (nStored_ > 0)
 	{
 		assert(id < N_);
 		if (id < minID_)
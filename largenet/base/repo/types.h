@@ -24,9 +24,34 @@
 namespace repo
 {
 typedef unsigned int category_t; ///< Category number type.
+#ifdef LARGENET_64BIT_ADDRESS
+/*
+ * 64-bit item numbers for repositories with more than 2^32 items. This must
+ * be a type distinct from id_t, because many functions are overloaded on
+ * item number and item ID.
+ */
+typedef unsigned long long int address_t; ///< Item number (array index) type.
+#else
 typedef unsigned int address_t; ///< Item number (array index) type.
+#endif
 typedef unsigned long int id_t; ///< Item unique ID type.
 typedef id_t id_size_t; ///< Item count type.
+
+/**
+ * Handle of a category group, see _Repo_base::addGroup(). This is a class
+ * rather than an integer so that functions can be overloaded on category and
+ * group.
+ */
+struct group_t
+{
+	explicit group_t(unsigned int i = 0) :
+		index(i)
+	{
+	}
+	unsigned int index; ///< Position of the group in the repository's list of groups.
+};
+
+const id_t INVALID_ID = static_cast<id_t>(-1); ///< Marks IDs that are not in use, e.g. in ID maps.
 }
 
 #endif /* REPO_TYPES_H_ */
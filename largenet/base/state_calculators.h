@@ -16,8 +16,10 @@
 
 #include <largenet/base/types.h>
 #include <largenet/motifs.h>
-#include <map>
+#include <vector>
 #include <utility>
+#include <stdexcept>
+#include <cassert>
 
 namespace lnet
 {
@@ -66,18 +68,113 @@ private:
 	link_state_size_t getNumberOfLinkStates() const;
 };
 
+/**
+ * Link state calculator looking up link states in a dense table indexed by
+ * both end nodes' states. A lookup is a single array access, so tabulating
+ * a more expensive calculator pays off if states are recalculated for every
+ * link of a node that changes its state.
+ */
+class LinkStateTable: public LinkStateCalculator
+{
+public:
+	/**
+	 * Constructor. Creates an empty table, to be filled using assign().
+	 */
+	LinkStateTable();
+	/**
+	 * Constructor tabulating the link states calculated by @p lsCalc.
+	 * @param lsCalc %Link state calculator to tabulate.
+	 * @param nNodeStates Number of node states.
+	 */
+	LinkStateTable(const LinkStateCalculator& lsCalc,
+			node_state_size_t nNodeStates);
+	/**
+	 * Replace the table by the link states calculated by @p lsCalc.
+	 * @param lsCalc %Link state calculator to tabulate.
+	 * @param nNodeStates Number of node states.
+	 */
+	void assign(const LinkStateCalculator& lsCalc,
+			node_state_size_t nNodeStates);
+	/**
+	 * Look up link state from end node states without a virtual function
+	 * call.
+	 * @param source Source node's state, less than numberOfNodeStates().
+	 * @param target Target node's state, less than numberOfNodeStates().
+	 * @return %Link state.
+	 */
+	link_state_t lookup(node_state_t source, node_state_t target) const;
+	/**
+	 * Return number of node states covered by the table.
+	 */
+	node_state_size_t numberOfNodeStates() const;
+
+protected:
+	/**
+	 * Constructor for derived classes filling the table using set().
+	 * @param nNodeStates Number of node states.
+	 * @param nLinkStates Number of link states.
+	 */
+	LinkStateTable(node_state_size_t nNodeStates,
+			link_state_size_t nLinkStates);
+	/**
+	 * Set link state for a pair of end node states.
+	 * @param source Source node's state.
+	 * @param target Target node's state.
+	 * @param s %Link state.
+	 */
+	void set(node_state_t source, node_state_t target, link_state_t s);
+
+private:
+	link_state_t fromNodeStates(node_state_t source, node_state_t target) const;
+	link_state_size_t getNumberOfLinkStates() const;
+	node_state_size_t nNodeStates_;
+	link_state_size_t nLinkStates_;
+	std::vector<link_state_t> table_; ///< state of (source, target) at source * nNodeStates_ + target
+};
+
 /**
  * 'Canonical' link state calculator, enumerating all possible link states
  * in motif-ascending order.
  */
-class DefaultLinkStateCalculator: public LinkStateCalculator
+class DefaultLinkStateCalculator: public LinkStateTable
 {
 public:
 	DefaultLinkStateCalculator(node_state_size_t nNodeStates);
+};
+
+/**
+ * Link state table for a number of node states fixed at compile time. The
+ * table is part of the object, and lookup() is a load at a constant stride.
+ * The network using it must have exactly @p _nNodeStates node states.
+ */
+template<node_state_size_t _nNodeStates>
+class FixedLinkStateTable: public LinkStateCalculator
+{
+public:
+	/**
+	 * Constructor. Uses the link states of DefaultLinkStateCalculator.
+	 */
+	FixedLinkStateTable();
+	/**
+	 * Constructor tabulating the link states calculated by @p lsCalc.
+	 * @param lsCalc %Link state calculator to tabulate.
+	 */
+	explicit FixedLinkStateTable(const LinkStateCalculator& lsCalc);
+	/**
+	 * Look up link state from end node states without a virtual function
+	 * call.
+	 * @param source Source node's state.
+	 * @param target Target node's state.
+	 * @return %Link state.
+	 */
+	link_state_t lookup(node_state_t source, node_state_t target) const;
+
 private:
+	void assign(const LinkStateCalculator& lsCalc);
 	link_state_t fromNodeStates(node_state_t source, node_state_t target) const;
 	link_state_size_t getNumberOfLinkStates() const;
-	std::map<motifs::LinkMotif, link_state_t> states_;
+	link_state_size_t nLinkStates_;
+	link_state_t table_[_nNodeStates * _nNodeStates];
 };
 
 /**
@@ -127,15 +224,118 @@ private:
 	triple_state_size_t getNumberOfTripleStates() const;
 };
 
-class DefaultTripleStateCalculator: public TripleStateCalculator
+/**
+ * Triple state calculator looking up triple states in a dense table indexed
+ * by the three nodes' states (see LinkStateTable).
+ */
+class TripleStateTable: public TripleStateCalculator
+{
+public:
+	/**
+	 * Constructor. Creates an empty table, to be filled using assign().
+	 */
+	TripleStateTable();
+	/**
+	 * Constructor tabulating the triple states calculated by @p tsCalc.
+	 * @param tsCalc Triple state calculator to tabulate.
+	 * @param nNodeStates Number of node states.
+	 */
+	TripleStateTable(const TripleStateCalculator& tsCalc,
+			node_state_size_t nNodeStates);
+	/**
+	 * Replace the table by the triple states calculated by @p tsCalc.
+	 * @param tsCalc Triple state calculator to tabulate.
+	 * @param nNodeStates Number of node states.
+	 */
+	void assign(const TripleStateCalculator& tsCalc,
+			node_state_size_t nNodeStates);
+	/**
+	 * Look up triple state from node states without a virtual function call.
+	 * @param left State of left node
+	 * @param center State of center node
+	 * @param right State of right node
+	 * @return Triple state
+	 */
+	triple_state_t lookup(node_state_t left, node_state_t center,
+			node_state_t right) const;
+	/**
+	 * Return number of node states covered by the table.
+	 */
+	node_state_size_t numberOfNodeStates() const;
+
+protected:
+	/**
+	 * Constructor for derived classes filling the table using set().
+	 * @param nNodeStates Number of node states.
+	 * @param nTripleStates Number of triple states.
+	 */
+	TripleStateTable(node_state_size_t nNodeStates,
+			triple_state_size_t nTripleStates);
+	/**
+	 * Set triple state for a combination of node states.
+	 * @param left State of left node
+	 * @param center State of center node
+	 * @param right State of right node
+	 * @param s Triple state
+	 */
+	void set(node_state_t left, node_state_t center, node_state_t right,
+			triple_state_t s);
+
+private:
+	triple_state_t fromNodeStates(node_state_t left, node_state_t center,
+			node_state_t right) const;
+	triple_state_size_t getNumberOfTripleStates() const;
+	id_size_t index(node_state_t left, node_state_t center,
+			node_state_t right) const;
+	node_state_size_t nNodeStates_;
+	triple_state_size_t nTripleStates_;
+	std::vector<triple_state_t> table_; ///< state of (left, center, right) at (left * nNodeStates_ + center) * nNodeStates_ + right
+};
+
+/**
+ * 'Canonical' triple state calculator, enumerating all possible triple
+ * states in motif-ascending order.
+ */
+class DefaultTripleStateCalculator: public TripleStateTable
 {
 public:
 	DefaultTripleStateCalculator(node_state_size_t nNodeStates);
+};
+
+/**
+ * Triple state table for a number of node states fixed at compile time
+ * (see FixedLinkStateTable).
+ */
+template<node_state_size_t _nNodeStates>
+class FixedTripleStateTable: public TripleStateCalculator
+{
+public:
+	/**
+	 * Constructor. Uses the triple states of DefaultTripleStateCalculator.
+	 */
+	FixedTripleStateTable();
+	/**
+	 * Constructor tabulating the triple states calculated by @p tsCalc.
+	 * @param tsCalc Triple state calculator to tabulate.
+	 */
+	explicit FixedTripleStateTable(const TripleStateCalculator& tsCalc);
+	/**
+	 * Look up triple state from node states without a virtual function call.
+	 * @param left State of left node
+	 * @param center State of center node
+	 * @param right State of right node
+	 * @return Triple state
+	 */
+	triple_state_t lookup(node_state_t left, node_state_t center,
+			node_state_t right) const;
+
 private:
+	void assign(const TripleStateCalculator& tsCalc);
 	triple_state_t fromNodeStates(node_state_t left, node_state_t center,
 			node_state_t right) const;
 	triple_state_size_t getNumberOfTripleStates() const;
-	std::map<motifs::TripleMotif, triple_state_t> states_;
+	triple_state_size_t nTripleStates_;
+	triple_state_t table_[_nNodeStates * _nNodeStates * _nNodeStates];
 };
 
 // implementation
@@ -182,30 +382,131 @@ inline link_state_size_t ConstLinkState<_ls>::getNumberOfLinkStates() const
 	return 1;
 }
 
+// link state table
+
+inline LinkStateTable::LinkStateTable() :
+	nNodeStates_(0), nLinkStates_(0)
+{
+}
+
+inline LinkStateTable::LinkStateTable(const LinkStateCalculator& lsCalc,
+		const node_state_size_t nNodeStates) :
+	nNodeStates_(0), nLinkStates_(0)
+{
+	assign(lsCalc, nNodeStates);
+}
+
+inline LinkStateTable::LinkStateTable(const node_state_size_t nNodeStates,
+		const link_state_size_t nLinkStates) :
+	nNodeStates_(nNodeStates), nLinkStates_(nLinkStates), table_(nNodeStates
+			* nNodeStates)
+{
+}
+
+inline void LinkStateTable::assign(const LinkStateCalculator& lsCalc,
+		const node_state_size_t nNodeStates)
+{
+	// fill a new table first, lsCalc might be this table itself
+	std::vector<link_state_t> table(nNodeStates * nNodeStates);
+	for (node_state_t a = 0; a < nNodeStates; ++a)
+		for (node_state_t b = 0; b < nNodeStates; ++b)
+			table[a * nNodeStates + b] = lsCalc(a, b);
+	nLinkStates_ = lsCalc.numberOfLinkStates();
+	nNodeStates_ = nNodeStates;
+	table_.swap(table);
+}
+
+inline link_state_t LinkStateTable::lookup(const node_state_t source,
+		const node_state_t target) const
+{
+	assert((source < nNodeStates_) && (target < nNodeStates_));
+	return table_[source * nNodeStates_ + target];
+}
+
+inline node_state_size_t LinkStateTable::numberOfNodeStates() const
+{
+	return nNodeStates_;
+}
+
+inline void LinkStateTable::set(const node_state_t source,
+		const node_state_t target, const link_state_t s)
+{
+	assert((source < nNodeStates_) && (target < nNodeStates_));
+	table_[source * nNodeStates_ + target] = s;
+}
+
+inline link_state_t LinkStateTable::fromNodeStates(const node_state_t source,
+		const node_state_t target) const
+{
+	return lookup(source, target);
+}
+
+inline link_state_size_t LinkStateTable::getNumberOfLinkStates() const
+{
+	return nLinkStates_;
+}
+
 // canonical link state calculator
 
 inline DefaultLinkStateCalculator::DefaultLinkStateCalculator(
-		const node_state_size_t nNodeStates)
+		const node_state_size_t nNodeStates) :
+	LinkStateTable(nNodeStates, nNodeStates * (nNodeStates + 1) / 2)
 {
 	// initialize
 	motifs::LinkMotifSet ls(nNodeStates);
 	link_state_t i = 0;
 	for (motifs::LinkMotifSet::const_iterator it = ls.begin(); it != ls.end(); ++it)
 	{
-		states_.insert(std::make_pair(*it, i));
+		set(it->source(), it->target(), i);
+		set(it->target(), it->source(), i);
 		++i;
 	}
 }
 
-inline link_state_t DefaultLinkStateCalculator::fromNodeStates(
+// fixed size link state table
+
+template<node_state_size_t _nNodeStates>
+inline FixedLinkStateTable<_nNodeStates>::FixedLinkStateTable()
+{
+	assign(DefaultLinkStateCalculator(_nNodeStates));
+}
+
+template<node_state_size_t _nNodeStates>
+inline FixedLinkStateTable<_nNodeStates>::FixedLinkStateTable(
+		const LinkStateCalculator& lsCalc)
+{
+	assign(lsCalc);
+}
+
+template<node_state_size_t _nNodeStates>
+void FixedLinkStateTable<_nNodeStates>::assign(
+		const LinkStateCalculator& lsCalc)
+{
+	for (node_state_t a = 0; a < _nNodeStates; ++a)
+		for (node_state_t b = 0; b < _nNodeStates; ++b)
+			table_[a * _nNodeStates + b] = lsCalc(a, b);
+	nLinkStates_ = lsCalc.numberOfLinkStates();
+}
+
+template<node_state_size_t _nNodeStates>
+inline link_state_t FixedLinkStateTable<_nNodeStates>::lookup(
+		const node_state_t source, const node_state_t target) const
+{
+	assert((source < _nNodeStates) && (target < _nNodeStates));
+	return table_[source * _nNodeStates + target];
+}
+
+template<node_state_size_t _nNodeStates>
+inline link_state_t FixedLinkStateTable<_nNodeStates>::fromNodeStates(
 		const node_state_t source, const node_state_t target) const
 {
-	return (states_.find(motifs::LinkMotif(source, target)))->second;
+	return lookup(source, target);
 }
 
-inline link_state_size_t DefaultLinkStateCalculator::getNumberOfLinkStates() const
+template<node_state_size_t _nNodeStates>
+inline link_state_size_t FixedLinkStateTable<_nNodeStates>::getNumberOfLinkStates() const
 {
-	return states_.size();
+	return nLinkStates_;
 }
 
 // triple state calculator
@@ -254,29 +555,235 @@ inline triple_state_size_t ConstTripleState<_ts>::getNumberOfTripleStates() cons
 	return 1;
 }
 
+// triple state table
+
+inline TripleStateTable::TripleStateTable() :
+	nNodeStates_(0), nTripleStates_(0)
+{
+}
+
+inline TripleStateTable::TripleStateTable(const TripleStateCalculator& tsCalc,
+		const node_state_size_t nNodeStates) :
+	nNodeStates_(0), nTripleStates_(0)
+{
+	assign(tsCalc, nNodeStates);
+}
+
+inline TripleStateTable::TripleStateTable(const node_state_size_t nNodeStates,
+		const triple_state_size_t nTripleStates) :
+	nNodeStates_(nNodeStates), nTripleStates_(nTripleStates), table_(
+			nNodeStates * nNodeStates * nNodeStates)
+{
+}
+
+inline void TripleStateTable::assign(const TripleStateCalculator& tsCalc,
+		const node_state_size_t nNodeStates)
+{
+	// fill a new table first, tsCalc might be this table itself
+	std::vector<triple_state_t> table(nNodeStates * nNodeStates * nNodeStates);
+	for (node_state_t a = 0; a < nNodeStates; ++a)
+		for (node_state_t b = 0; b < nNodeStates; ++b)
+			for (node_state_t c = 0; c < nNodeStates; ++c)
+				table[(a * nNodeStates + b) * nNodeStates + c] = tsCalc(a, b, c);
+	nTripleStates_ = tsCalc.numberOfTripleStates();
+	nNodeStates_ = nNodeStates;
+	table_.swap(table);
+}
+
+inline id_size_t TripleStateTable::index(const node_state_t left,
+		const node_state_t center, const node_state_t right) const
+{
+	assert((left < nNodeStates_) && (center < nNodeStates_) && (right
+			< nNodeStates_));
+	return (left * nNodeStates_ + center) * nNodeStates_ + right;
+}
+
+inline triple_state_t TripleStateTable::lookup(const node_state_t left,
+		const node_state_t center, const node_state_t right) const
+{
+	return table_[index(left, center, right)];
+}
+
+inline node_state_size_t TripleStateTable::numberOfNodeStates() const
+{
+	return nNodeStates_;
+}
+
+inline void TripleStateTable::set(const node_state_t left,
+		const node_state_t center, const node_state_t right,
+		const triple_state_t s)
+{
+	table_[index(left, center, right)] = s;
+}
+
+inline triple_state_t TripleStateTable::fromNodeStates(
+		const node_state_t left, const node_state_t center,
+		const node_state_t right) const
+{
+	return lookup(left, center, right);
+}
+
+inline triple_state_size_t TripleStateTable::getNumberOfTripleStates() const
+{
+	return nTripleStates_;
+}
+
 // canonical triple state calculator
 inline DefaultTripleStateCalculator::DefaultTripleStateCalculator(
-		const node_state_size_t nNodeStates)
+		const node_state_size_t nNodeStates) :
+	TripleStateTable(nNodeStates, nNodeStates * nNodeStates * (nNodeStates
+			+ 1) / 2)
 {
 	motifs::TripleMotifSet ts(nNodeStates);
 	triple_state_t i = 0;
 	for (motifs::TripleMotifSet::const_iterator it = ts.begin(); it != ts.end(); ++it)
 	{
-		states_.insert(std::make_pair(*it, i));
+		set(it->left(), it->center(), it->right(), i);
+		set(it->right(), it->center(), it->left(), i);
 		++i;
 	}
 }
 
-inline triple_state_t DefaultTripleStateCalculator::fromNodeStates(
+// fixed size triple state table
+
+template<node_state_size_t _nNodeStates>
+inline FixedTripleStateTable<_nNodeStates>::FixedTripleStateTable()
+{
+	assign(DefaultTripleStateCalculator(_nNodeStates));
+}
+
+template<node_state_size_t _nNodeStates>
+inline FixedTripleStateTable<_nNodeStates>::FixedTripleStateTable(
+		const TripleStateCalculator& tsCalc)
+{
+	assign(tsCalc);
+}
+
+template<node_state_size_t _nNodeStates>
+void FixedTripleStateTable<_nNodeStates>::assign(
+		const TripleStateCalculator& tsCalc)
+{
+	for (node_state_t a = 0; a < _nNodeStates; ++a)
+		for (node_state_t b = 0; b < _nNodeStates; ++b)
+			for (node_state_t c = 0; c < _nNodeStates; ++c)
+				table_[(a * _nNodeStates + b) * _nNodeStates + c] = tsCalc(a,
+						b, c);
+	nTripleStates_ = tsCalc.numberOfTripleStates();
+}
+
+template<node_state_size_t _nNodeStates>
+inline triple_state_t FixedTripleStateTable<_nNodeStates>::lookup(
 		const node_state_t left, const node_state_t center,
 		const node_state_t right) const
 {
-	return (states_.find(motifs::TripleMotif(left, center, right)))->second;
+	assert((left < _nNodeStates) && (center < _nNodeStates) && (right
+			< _nNodeStates));
+	return table_[(left * _nNodeStates + center) * _nNodeStates + right];
+}
+
+template<node_state_size_t _nNodeStates>
+inline triple_state_t FixedTripleStateTable<_nNodeStates>::fromNodeStates(
+		const node_state_t left, const node_state_t center,
+		const node_state_t right) const
+{
+	return lookup(left, center, right);
+}
+
+template<node_state_size_t _nNodeStates>
+inline triple_state_size_t FixedTripleStateTable<_nNodeStates>::getNumberOfTripleStates() const
+{
+	return nTripleStates_;
 }
 
-inline triple_state_size_t DefaultTripleStateCalculator::getNumberOfTripleStates() const
+namespace detail
 {
-	return states_.size();
+
+/**
+ * Create the link state calculator a network working with calculators of type
+ * @p _LinkStates uses if none is given. This is a default-constructed
+ * @p _LinkStates, so other types do not compile.
+ */
+template<class _LinkStates>
+struct DefaultLinkStates
+{
+	static LinkStateCalculator* create(node_state_size_t)
+	{
+		return new _LinkStates();
+	}
+	/// Number of node states a default network should have if @p n are asked for.
+	static node_state_size_t numberOfNodeStates(const node_state_size_t n)
+	{
+		return n;
+	}
+};
+
+/**
+ * Fixed link state tables only work for their own number of node states.
+ */
+template<node_state_size_t _nNodeStates>
+struct DefaultLinkStates<FixedLinkStateTable<_nNodeStates> >
+{
+	static LinkStateCalculator* create(const node_state_size_t nNodeStates)
+	{
+		if (nNodeStates != _nNodeStates)
+			throw(std::invalid_argument(
+					"Number of node states does not match FixedLinkStateTable!"));
+		return new FixedLinkStateTable<_nNodeStates> ();
+	}
+	static node_state_size_t numberOfNodeStates(node_state_size_t)
+	{
+		return _nNodeStates;
+	}
+};
+
+/**
+ * Calculator types that DefaultLinkStateCalculator is derived from use that.
+ */
+template<>
+struct DefaultLinkStates<LinkStateCalculator>
+{
+	static LinkStateCalculator* create(const node_state_size_t nNodeStates)
+	{
+		return new DefaultLinkStateCalculator(nNodeStates);
+	}
+	static node_state_size_t numberOfNodeStates(const node_state_size_t n)
+	{
+		return n;
+	}
+};
+
+template<>
+struct DefaultLinkStates<LinkStateTable> : public DefaultLinkStates<
+		LinkStateCalculator>
+{
+};
+
+template<>
+struct DefaultLinkStates<DefaultLinkStateCalculator> : public DefaultLinkStates<
+		LinkStateCalculator>
+{
+};
+
+/**
+ * Calculate link state through the virtual interface of @p lsCalc.
+ */
+inline link_state_t linkState(const LinkStateCalculator& lsCalc,
+		const node_state_t source, const node_state_t target)
+{
+	return lsCalc(source, target);
+}
+
+/**
+ * Calculate link state using the non-virtual lookup() of a calculator of
+ * known type, e.g. a LinkStateTable.
+ */
+template<class _LinkStates>
+inline link_state_t linkState(const _LinkStates& lsCalc,
+		const node_state_t source, const node_state_t target)
+{
+	return lsCalc.lookup(source, target);
+}
+
 }
 
 }
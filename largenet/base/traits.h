@@ -23,6 +23,13 @@ struct disallow_parallel_edge_tag {};
 struct count_triples_tag {};
 struct no_count_triples_tag {};
 
+/// %Node keeps adjacent link IDs in an ordered set (see Node).
+struct set_adjacency_tag {};
+/// %Node keeps adjacent link IDs in an array, links know their slots (see FlatNode, FlatLink).
+struct flat_adjacency_tag {};
+/// %Node keeps adjacent link IDs in an array grouped by neighbor state, links know their slots (see PartitionedNode, FlatLink).
+struct partitioned_adjacency_tag {};
+
 template<class _Network>
 struct network_traits
 {
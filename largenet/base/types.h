@@ -23,6 +23,10 @@
 #ifndef LNET_TYPES_H_
 #define LNET_TYPES_H_
 
+#include <largenet/base/repo/types.h>
+#include <vector>
+#include <utility>
+
 namespace lnet
 {
 ///@{
@@ -39,8 +43,23 @@ typedef link_state_t link_state_size_t; ///< %Link state size type.
 typedef unsigned int triple_state_t; ///< %Triple state type.
 typedef triple_state_t triple_state_size_t; ///< %Triple state size type.
 
+typedef repo::group_t state_group_t; ///< Handle of a group of node, link, or triple states.
+
 typedef struct {} no_type;
 
+typedef std::vector<std::pair<node_id_t, node_id_t> > EdgeList; ///< List of (source, target) node ID pairs.
+
+/**
+ * Maps from old to new IDs, as returned by BasicNetwork::compact(). Old IDs
+ * that were not in use map to repo::INVALID_ID.
+ */
+struct IDMap
+{
+	std::vector<node_id_t> nodes; ///< %Node ID map.
+	std::vector<link_id_t> links; ///< %Link ID map.
+	std::vector<triple_id_t> triples; ///< %Triple ID map (empty for networks without triples).
+};
+
 }
 
 #endif /* LNET_TYPES_H_ */
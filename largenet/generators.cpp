@@ -44,6 +44,8 @@ void randomNetworkGnm(BasicNetwork& net, const id_size_t nLinks)
 	 */
 
 	edge_set edges;
+	EdgeList links;
+	links.reserve(nLinks);
 	edge_t current_edge;
 	for (id_size_t i = 0; i < nLinks; ++i)
 	{
@@ -60,11 +62,12 @@ void randomNetworkGnm(BasicNetwork& net, const id_size_t nLinks)
 			if (edges.find(current_edge) == edges.end())
 			{
 				edges.insert(current_edge);
-				net.addLink(current_edge.first, current_edge.second);
+				links.push_back(current_edge);
 				break;
 			}
 		}
 	}
+	net.addLinks(links);
 }
 
 }
@@ -8,6 +8,7 @@
 #include "EdgelistIn.h"
 #include <largenet/base/types.h>
 #include <largenet/base/BasicNetwork.h>
+#include <largenet/NetworkBuilder.h>
 #include <string>
 #include <sstream>
 #include <cassert>
@@ -50,7 +51,7 @@ bool EdgelistIn::get(std::istream& in, BasicNetwork& net)
 	stringstream ss;
 
 	link_vector links;
-	node_info a, b;
+	node_info a = { 0, 0 }, b = { 0, 0 };
 	node_state_size_t node_states = readStates_ ? 1 : net.numberOfNodeStates();
 	node_id_t max_node_id = 0;
 
@@ -83,13 +84,15 @@ bool EdgelistIn::get(std::istream& in, BasicNetwork& net)
 		links.push_back(std::make_pair(a, b));
 	}
 
-	net.reset(max_node_id + 1, links.size(), node_states);
+	NetworkBuilder builder(max_node_id + 1, node_states);
+	builder.reserveLinks(links.size());
 	for (link_vector::iterator it = links.begin(); it != links.end(); ++it)
 	{
-		net.setNodeState(it->first.id, it->first.state);
-		net.setNodeState(it->second.id, it->second.state);
-		net.addLink(it->first.id, it->second.id);
+		builder.setNodeState(it->first.id, it->first.state);
+		builder.setNodeState(it->second.id, it->second.state);
+		builder.addLink(it->first.id, it->second.id);
 	}
+	builder.build(net);
 	return true;
 }
 
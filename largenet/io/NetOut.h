@@ -58,8 +58,9 @@ inline bool NetOut::writesStates() const
 template<class _Network>
 inline bool NetOut::put(std::ostream& out, const _Network& net) const
 {
-	// make a copy in order to get a contiguous range of valid IDs
+	// make a compacted copy in order to get a contiguous range of valid IDs
 	_Network n(net);
+	n.compact();
 	return doPut(out, n);
 }
 
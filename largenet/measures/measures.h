@@ -101,16 +101,7 @@ void degreeDistribution(const _Network& net, degree_dist_t& dist,
 	for (typename network_traits<_Network>::NodeStateIterator& it = iters.first; it
 			!= iters.second; ++it)
 	{
-		typename network_traits<_Network>::NeighborIteratorRange neighbors =
-				net.neighbors(*it);
-		id_size_t deg = 0;
-		for (typename network_traits<_Network>::NeighborIterator& nit =
-				neighbors.first; nit != neighbors.second; ++nit)
-		{
-			if (net.nodeState(*nit) == target)
-				++deg;
-		}
-
+		id_size_t deg = net.neighborsInState(*it, target);
 		while (deg >= dist.size())
 		{
 			dist.push_back(0);
@@ -363,14 +354,7 @@ id_size_t triples(const _Network& net, const motifs::TripleMotif& t)
 		}
 
 		// count all c-neighbors of the b node
-		typename network_traits<_Network>::NeighborIteratorRange niters =
-				net.neighbors(right);
-		for (typename network_traits<_Network>::NeighborIterator& nit =
-				niters.first; nit != niters.second; ++nit)
-		{
-			if (net.nodeState(*nit) == t.right())
-				++ret;
-		}
+		ret += net.neighborsInState(right, t.right());
 
 		// exclude left a in an a-b-a triple
 		if (t.isSymmetric())
@@ -380,14 +364,7 @@ id_size_t triples(const _Network& net, const motifs::TripleMotif& t)
 		if (t.left() == t.center())
 		{
 			// count all c-neighbors of the left node
-			typename network_traits<_Network>::NeighborIteratorRange niters =
-					net.neighbors(left);
-			for (typename network_traits<_Network>::NeighborIterator & nit =
-					niters.first; nit != niters.second; ++nit)
-			{
-				if (net.nodeState(*nit) == t.right())
-					++ret;
-			}
+			ret += net.neighborsInState(left, t.right());
 
 			// exclude left a in an a-b-a triple
 			if (t.isSymmetric())
@@ -592,20 +569,32 @@ id_size_t quadStars(const _Network& net, node_state_t center, node_state_t a,
 	typedef typename network_traits<_Network>::NeighborIteratorRange NIRange;
 	typedef typename network_traits<_Network>::NeighborIterator NI;
 
+	// without counts, neighborsInState() scans, so do one scan for all three
+	const bool counted = net.hasNeighborStateCounts();
 	id_size_t ret = 0;
 	NSIRange nodes = net.nodes(center);
 	for (NSI i = nodes.first; i != nodes.second; ++i)
 	{
 		id_size_t an = 0, bn = 0, cn = 0;
-		NIRange neighbors = net.neighbors(*i);
-		for (NI n = neighbors.first; n != neighbors.second; ++n)
+		if (counted)
 		{
-			if (net.nodeState(*n) == a)
-				++an;
-			if (net.nodeState(*n) == b)
-				++bn;
-			if (net.nodeState(*n) == c)
-				++cn;
+			an = net.neighborsInState(*i, a);
+			bn = net.neighborsInState(*i, b);
+			cn = net.neighborsInState(*i, c);
+		}
+		else
+		{
+			NIRange neighbors = net.neighbors(*i);
+			for (NI n = neighbors.first; n != neighbors.second; ++n)
+			{
+				const node_state_t s = net.nodeState(*n);
+				if (s == a)
+					++an;
+				if (s == b)
+					++bn;
+				if (s == c)
+					++cn;
+			}
 		}
 		long int q = an;
 		if (a == b)